@@ -0,0 +1,433 @@
+// Micro- and end-to-end benchmarks of the analysis.
+//
+// Each benchmark is timed over as many iterations as fit into the minimum
+// measurement time (see --min-time); the results are written as one JSON
+// document, so that runs before and after a change can be compared.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+
+#include "OptionParser.h"
+#include "config.h"
+
+#include "problem.hpp"
+#include "io.hpp"
+#include "generator.hpp"
+#include "data_age_analysis.hpp"
+#include "uni/space.hpp"
+#include "uni/por_space.hpp"
+#include "uni/por_criterion.hpp"
+
+using namespace NP;
+using namespace NP::Uniproc;
+
+typedef dtime_t Time;
+
+// keeps the optimiser from discarding a benchmarked computation
+static volatile std::size_t sink;
+
+struct Result {
+	std::string name;
+	// members of the JSON objects "params" and "metrics"
+	std::string params, metrics;
+	unsigned long iterations;
+	double seconds;
+};
+
+static std::vector<Result> results;
+static std::string filter;
+static double min_time = 0.2;
+static bool want_large = false;
+
+static bool selected(const std::string &name)
+{
+	return filter.empty() || name.find(filter) != std::string::npos;
+}
+
+// Time `op`, doubling the number of iterations until the measurement lasts
+// at least min_time.
+static void measure(const std::string &name, const std::string &params,
+					std::function<void()> op, const std::string &metrics = "")
+{
+	if (!selected(name))
+		return;
+	typedef std::chrono::steady_clock Clock;
+	op(); // warm-up
+	for (unsigned long n = 1; ; n *= 2) {
+		auto start = Clock::now();
+		for (unsigned long i = 0; i < n; i++)
+			op();
+		double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+		if (elapsed >= min_time || n >= (1UL << 30)) {
+			results.push_back(Result{name, params, metrics, n, elapsed});
+			std::cerr << name << ": " << elapsed / n * 1E9 << " ns/op ("
+					  << n << " iterations)" << std::endl;
+			return;
+		}
+	}
+}
+
+static std::string param(const std::string &key, double value)
+{
+	std::ostringstream s;
+	s << "\"" << key << "\": " << value;
+	return s.str();
+}
+
+static std::string param(const std::string &key, const std::string &value)
+{
+	return "\"" + key + "\": \"" + value + "\"";
+}
+
+// ---- Index_set ----
+
+static Index_set set_of(std::size_t n, std::size_t stride)
+{
+	Index_set s;
+	for (std::size_t i = 0; i < n; i += stride)
+		s.add(i);
+	return s;
+}
+
+static void bench_index_set()
+{
+	for (std::size_t n : {64, 1024, 16384}) {
+		std::string p = param("indices", n);
+		Index_set a = set_of(n, 1), b = set_of(n, 3);
+
+		measure("index_set/add/" + std::to_string(n), p, [n] {
+			sink = set_of(n, 1).size();
+		});
+		measure("index_set/contains/" + std::to_string(n), p, [&b, n] {
+			std::size_t c = 0;
+			for (std::size_t i = 0; i < n; i++)
+				c += b.contains(i);
+			sink = c;
+		});
+		measure("index_set/union/" + std::to_string(n), p, [&a, &b] {
+			Index_set u = b;
+			u.add(a);
+			sink = u.heap_bytes();
+		});
+		measure("index_set/subset/" + std::to_string(n), p, [&a, &b] {
+			sink = b.is_subset_of(a);
+		});
+		measure("index_set/equal/" + std::to_string(n), p, [&a, &b] {
+			sink = a == b;
+		});
+		measure("index_set/size/" + std::to_string(n), p, [&a] {
+			sink = a.size();
+		});
+		measure("index_set/extend/" + std::to_string(n), p, [&a, n] {
+			sink = Index_set(a, n).heap_bytes();
+		});
+	}
+}
+
+// ---- Reduction_set ----
+
+// k jobs released close together, so that they may form a reduction set
+static Job<Time>::Job_set overlapping_jobs(std::size_t k)
+{
+	Job<Time>::Job_set jobs;
+	Workload_random rng(k);
+	for (std::size_t i = 0; i < k; i++) {
+		Time release = 10 * i;
+		Time wcet = 5 + rng.below(20);
+		Time dl = 100000 + 10 * i;
+		jobs.emplace_back(i, Interval<Time>{release, release + 5},
+						  Interval<Time>{wcet / 2, wcet}, dl, dl, i);
+	}
+	return jobs;
+}
+
+static void bench_reduction_set()
+{
+	for (std::size_t k : {4, 16, 64}) {
+		std::string p = param("jobs", k);
+		auto jobs = overlapping_jobs(k);
+		Reduction_set<Time>::Job_set all;
+		std::vector<std::size_t> indices;
+		for (std::size_t i = 0; i < k; i++) {
+			all.push_back(&jobs[i]);
+			indices.push_back(i);
+		}
+
+		measure("reduction_set/construct/" + std::to_string(k), p, [&] {
+			Reduction_set<Time> r{Interval<Time>{0, 10}, all, indices};
+			sink = r.get_latest_busy_time();
+		});
+
+		// start from two jobs and add the others one by one
+		Reduction_set<Time>::Job_set first(all.begin(), all.begin() + 2);
+		std::vector<std::size_t> first_indices(indices.begin(), indices.begin() + 2);
+		Reduction_set<Time>::Job_precedence_set no_predecessors;
+		Index_set none_scheduled;
+		measure("reduction_set/grow/" + std::to_string(k), p, [&] {
+			Reduction_set<Time> r{Interval<Time>{0, 10}, first, first_indices};
+			for (std::size_t i = 2; i < k; i++)
+				if (r.can_interfere(*all[i], no_predecessors, none_scheduled))
+					r.add_job(all[i], i);
+			sink = r.get_latest_busy_time();
+		});
+	}
+}
+
+// ---- Schedule_state ----
+
+static void bench_schedule_state()
+{
+	for (std::size_t n : {64, 1024, 16384}) {
+		std::string p = param("jobs", n);
+		auto jobs = overlapping_jobs(n);
+		measure("schedule_state/transition/" + std::to_string(n), p, [&] {
+			std::unique_ptr<Schedule_state<Time>> s(new Schedule_state<Time>());
+			for (std::size_t i = 0; i < n; i++) {
+				Time f = s->latest_finish_time() + jobs[i].maximal_cost();
+				s.reset(new Schedule_state<Time>(*s, jobs[i], i, Interval<Time>{f / 2, f}, f));
+			}
+			sink = s->get_key();
+		});
+	}
+}
+
+// ---- generated workloads ----
+
+struct Workload_point {
+	std::string label;
+	Workload_parameters params;
+	std::string periods;
+};
+
+static std::string describe(const Workload_point &w)
+{
+	return param("tasks", w.params.num_tasks)
+		   + ", " + param("pes", w.params.num_pes)
+		   + ", " + param("utilization", w.params.utilization)
+		   + ", " + param("periods", w.periods)
+		   + ", " + param("jitter", w.params.jitter)
+		   + ", " + param("chain_length", w.params.chain_length)
+		   + ", " + param("seed", w.params.seed);
+}
+
+// a base workload, and variations of one parameter at a time
+static std::vector<Workload_point> workload_sweep()
+{
+	std::vector<Workload_point> points;
+	auto add = [&points](const std::string &label, unsigned int tasks, unsigned int pes,
+						 double u, const std::string &periods, unsigned int chain) {
+		Workload_point w;
+		w.label = label;
+		w.params.num_tasks = tasks;
+		w.params.num_pes = pes;
+		w.params.utilization = u;
+		w.params.periods = period_distribution(periods);
+		w.periods = periods;
+		w.params.chain_length = chain;
+		// keeps the end-to-end runs short
+		w.params.jitter = 0.001;
+		points.push_back(w);
+	};
+	add("base", 20, 2, 0.5, "harmonic", 4);
+	add("tasks=10", 10, 2, 0.5, "harmonic", 4);
+	add("tasks=40", 40, 2, 0.5, "harmonic", 4);
+	add("pes=1", 20, 1, 0.5, "harmonic", 4);
+	add("pes=4", 20, 4, 0.5, "harmonic", 4);
+	add("utilization=0.3", 20, 2, 0.3, "harmonic", 4);
+	add("utilization=0.7", 20, 2, 0.7, "harmonic", 4);
+	add("periods=loose", 20, 2, 0.5, "loose", 4);
+	add("periods=automotive", 10, 2, 0.5, "automotive", 4);
+	add("chain=2", 20, 2, 0.5, "harmonic", 2);
+	add("chain=8", 20, 2, 0.5, "harmonic", 8);
+	return points;
+}
+
+// response-time bounds of all jobs, as computed by run_analysis
+template<class Space>
+static bool explore_all(const Generated_jobs<Time> &generated, unsigned int num_pes,
+						std::unordered_map<JobID, Interval<Time>> &sta,
+						std::unordered_map<JobID, Interval<Time>> &rta,
+						unsigned long &states)
+{
+	bool schedulable = true;
+	states = 0;
+	for (unsigned int pe = 0; pe < num_pes; pe++) {
+		auto jobs = generated.workload_of_pe(pe);
+		if (jobs.empty())
+			continue;
+		Scheduling_problem<Time> problem{std::move(jobs), 1};
+		Analysis_options opts;
+		opts.num_buckets = problem.jobs.size();
+		// explore everything, also past deadline misses
+		opts.early_exit = false;
+		auto space = Space::explore(problem, opts);
+		schedulable = schedulable && space.is_schedulable();
+		states += space.number_of_states();
+		for (const auto &j : problem.jobs) {
+			sta.emplace(j.get_id(), space.get_start_times(j));
+			rta.emplace(j.get_id(), space.get_finish_times(j));
+		}
+	}
+	return schedulable;
+}
+
+template<class Space>
+static void bench_end_to_end(const std::string &group, const std::string &engine, const Workload_point &w,
+							 const Generated_jobs<Time> &generated)
+{
+	std::string name = group + "/" + engine + "/" + w.label;
+	if (!selected(name))
+		return;
+	std::unordered_map<JobID, Interval<Time>> sta, rta;
+	unsigned long states;
+	bool schedulable = explore_all<Space>(generated, w.params.num_pes, sta, rta, states);
+	std::string metrics = param("jobs", generated.jobs.size())
+						  + ", " + param("states", states)
+						  + ", " + "\"schedulable\": " + (schedulable ? "true" : "false");
+	measure(name, describe(w), [&] {
+		std::unordered_map<JobID, Interval<Time>> s, r;
+		unsigned long n;
+		explore_all<Space>(generated, w.params.num_pes, s, r, n);
+		sink = n;
+	}, metrics);
+}
+
+static void bench_workloads()
+{
+	typedef State_space<Time, Null_IIP<Time>> Plain;
+	typedef Por_state_space<Time, Null_IIP<Time>, POR_release_order<Time>> Por;
+
+	for (const auto &w : workload_sweep()) {
+		auto g = generate_dag<Time>(w.params);
+		g.calculate_hyperperiod();
+		auto generated = generate_job_set<Time>(g);
+		std::string p = describe(w);
+		std::string jobs = param("jobs", generated.jobs.size());
+
+		measure("generate_job_set/" + w.label, p, [&g] {
+			sink = generate_job_set<Time>(g).jobs.size();
+		}, jobs);
+
+		bench_end_to_end<Plain::Abort_free>("end_to_end", "plain", w, generated);
+		bench_end_to_end<Por::Abort_free>("end_to_end", "por", w, generated);
+
+		std::string name = "data_age_analysis/" + w.label;
+		if (!selected(name) || g.get_task_chains().empty())
+			continue;
+		std::unordered_map<JobID, Interval<Time>> sta, rta;
+		unsigned long states;
+		if (!explore_all<Por::Abort_free>(generated, w.params.num_pes, sta, rta, states))
+			continue;
+		const auto &chain = g.get_task_chains().front();
+		measure(name, p, [&] {
+			Data_age_analysis<Time> a(generated.jobs, sta, rta, chain);
+			sink = a.get_data_age().until();
+		}, jobs);
+	}
+}
+
+// Analyses of ever more jobs (on one PE; about 10^2 and 10^3 jobs, and
+// 10^4 and 4*10^4 jobs with --large), generated in memory
+static void bench_scaling()
+{
+	typedef State_space<Time, Null_IIP<Time>> Plain;
+	typedef Por_state_space<Time, Null_IIP<Time>, POR_release_order<Time>> Por;
+
+	std::vector<unsigned int> sizes = {2, 16, 160};
+	if (want_large) {
+		sizes.push_back(500);
+		sizes.push_back(1600);
+	}
+	for (auto n : sizes) {
+		Workload_point w;
+		w.label = "tasks=" + std::to_string(n);
+		w.params.num_tasks = n;
+		w.params.num_pes = 1;
+		w.params.jitter = 0;
+		w.params.chain_length = 2;
+		w.params.edge_probability = 0;
+		w.periods = "harmonic";
+
+		auto g = generate_dag<Time>(w.params);
+		g.calculate_hyperperiod();
+		auto generated = generate_job_set<Time>(g);
+		bench_end_to_end<Plain::Abort_free>("scaling", "plain", w, generated);
+		bench_end_to_end<Por::Abort_free>("scaling", "por", w, generated);
+	}
+}
+
+static void write_json(std::ostream &out)
+{
+	out << "{\n  \"context\": {\"min_time\": " << min_time
+		<< ", \"large\": " << (want_large ? "true" : "false")
+		<< ", \"statistics\": "
+#ifdef CONFIG_COLLECT_STATISTICS
+		<< "true"
+#else
+		<< "false"
+#endif
+		<< "},\n  \"benchmarks\": [";
+	for (std::size_t i = 0; i < results.size(); i++) {
+		const auto &r = results[i];
+		out << (i ? ",\n" : "\n")
+			<< "    {\"name\": \"" << r.name << "\""
+			<< ", \"iterations\": " << r.iterations
+			<< ", \"seconds\": " << r.seconds
+			<< ", \"ns_per_op\": " << r.seconds / r.iterations * 1E9
+			<< ", \"params\": {" << r.params << "}"
+			<< ", \"metrics\": {" << r.metrics << "}}";
+	}
+	out << "\n  ]\n}\n";
+}
+
+int main(int argc, char **argv)
+{
+	auto parser = optparse::OptionParser();
+
+	parser.description("Micro- and end-to-end benchmarks of the analysis; "
+					   "the results are written in JSON format.");
+
+	parser.add_option("-f", "--filter").dest("filter").metavar("TEXT")
+			.help("only run the benchmarks whose name contains TEXT (default: all)")
+			.set_default("");
+
+	parser.add_option("-t", "--min-time").dest("min_time").metavar("SECONDS")
+			.help("minimum measurement time per benchmark (default: 0.2)")
+			.set_default("0.2");
+
+	parser.add_option("-o", "--output").dest("output").metavar("FILE")
+			.help("write the results to FILE (default: stdout)")
+			.set_default("");
+
+	parser.add_option("--large").dest("large").set_default("0")
+			.action("store_const").set_const("1")
+			.help("also analyse workloads of about 10^4 and 4*10^4 jobs (default: off)");
+
+	auto options = parser.parse_args(argc, argv);
+	want_large = options.get("large");
+	filter = (std::string) options.get("filter");
+	min_time = options.get("min_time");
+	std::string output = options.get("output");
+
+	bench_index_set();
+	bench_reduction_set();
+	bench_schedule_state();
+	bench_workloads();
+	bench_scaling();
+
+	if (output.empty())
+		write_json(std::cout);
+	else {
+		auto out = std::ofstream(output, std::ios::out);
+		write_json(out);
+		if (!out) {
+			std::cerr << "Error: cannot write " << output << std::endl;
+			return 1;
+		}
+	}
+	return 0;
+}
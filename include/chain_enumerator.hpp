@@ -0,0 +1,250 @@
+#ifndef CHAIN_ENUMERATOR_HPP
+#define CHAIN_ENUMERATOR_HPP
+
+#include <vector>
+#include <algorithm>
+
+#include "dag.hpp"
+
+namespace NP {
+
+	// Limits and filters for the enumeration of task chains
+	struct Chain_enumeration_options {
+		// stop after this many chains (zero means unlimited)
+		std::size_t max_chains = 0;
+
+		// skip chains with more tasks than this (zero means unlimited)
+		std::size_t max_length = 0;
+
+		// task IDs at which chains may start (empty means all source tasks)
+		std::vector<unsigned long> sources;
+
+		// task IDs at which chains may end (empty means all sink tasks)
+		std::vector<unsigned long> sinks;
+	};
+
+	// Lazily enumerates the task chains of a dag, one at a time, with an
+	// iterative depth-first search over the task graph. Memory use is linear
+	// in the number of tasks, independent of the number of chains.
+	//
+	// Chains are produced in a deterministic order: start tasks in task
+	// order, then depth-first in edge order.
+	template<class Time>
+	class Chain_enumerator {
+	public:
+		typedef typename dag<Time>::Task_chain Task_chain;
+
+		Chain_enumerator(dag<Time> &graph, const Chain_enumeration_options &opts = Chain_enumeration_options())
+				: graph(graph)
+				, opts(opts)
+				, is_end(graph.get_tasks().size(), false)
+				, on_path(graph.get_tasks().size(), false)
+				, next_start(0)
+				, emitted(0)
+		{
+			std::size_t n = graph.get_tasks().size();
+
+			if (opts.sources.empty()) {
+				std::vector<bool> has_pred(n, false);
+				for (std::size_t v = 0; v < n; v++) {
+					const std::size_t *succ = graph.successors(v);
+					for (std::size_t k = 0, m = graph.out_degree(v); k < m; k++)
+						has_pred[succ[k]] = true;
+				}
+				for (std::size_t v = 0; v < n; v++)
+					if (!has_pred[v])
+						start_tasks.push_back(v);
+			} else {
+				for (auto id: opts.sources)
+					start_tasks.push_back(graph.index_of_task(id));
+				std::sort(start_tasks.begin(), start_tasks.end());
+				start_tasks.erase(std::unique(start_tasks.begin(), start_tasks.end()), start_tasks.end());
+			}
+
+			if (opts.sinks.empty()) {
+				for (std::size_t v = 0; v < n; v++)
+					is_end[v] = graph.out_degree(v) == 0;
+			} else {
+				for (auto id: opts.sinks)
+					is_end[graph.index_of_task(id)] = true;
+			}
+		}
+
+		// Stores the next chain in `chain` and returns true, or returns false
+		// if there are no more chains (or the cap has been reached).
+		bool next(Task_chain &chain)
+		{
+			if (opts.max_chains && emitted >= opts.max_chains)
+				return false;
+
+			while (true) {
+				if (path.empty()) {
+					if (next_start == start_tasks.size())
+						return false;
+					push(start_tasks[next_start++]);
+					if (emit(chain))
+						return true;
+					continue;
+				}
+
+				std::size_t v = path.back();
+				std::size_t &k = cursor.back();
+				bool may_grow = !opts.max_length || path.size() < opts.max_length;
+
+				if (may_grow && k < graph.out_degree(v)) {
+					std::size_t w = graph.successors(v)[k++];
+					// guard against cycles
+					if (on_path[w])
+						continue;
+					push(w);
+					if (emit(chain))
+						return true;
+				} else {
+					on_path[v] = false;
+					path.pop_back();
+					cursor.pop_back();
+				}
+			}
+		}
+
+		// Accounts for all chains that next() yields in the observation
+		// window of the dag (see dag::require_observation_window()) without
+		// enumerating them, with a dynamic program over a topological order
+		// in O((tasks + edges) * max_length). If the number of chains is
+		// capped or the task graph has a cycle, the chains are enumerated
+		// instead (by a separate enumerator).
+		void require_observation_window()
+		{
+			const auto &tasks = graph.get_tasks();
+			std::size_t n = tasks.size();
+
+			std::vector<std::size_t> in_degree(n, 0), order;
+			order.reserve(n);
+			for (std::size_t v = 0; v < n; v++) {
+				const std::size_t *succ = graph.successors(v);
+				for (std::size_t k = 0, m = graph.out_degree(v); k < m; k++)
+					in_degree[succ[k]]++;
+			}
+			for (std::size_t v = 0; v < n; v++)
+				if (in_degree[v] == 0)
+					order.push_back(v);
+			for (std::size_t head = 0; head < order.size(); head++) {
+				auto v = order[head];
+				const std::size_t *succ = graph.successors(v);
+				for (std::size_t k = 0, m = graph.out_degree(v); k < m; k++)
+					if (--in_degree[succ[k]] == 0)
+						order.push_back(succ[k]);
+			}
+
+			if (opts.max_chains || order.size() != n) {
+				Chain_enumerator chains(graph, opts);
+				Task_chain tc;
+				while (chains.next(tc))
+					graph.require_observation_window(tc);
+				return;
+			}
+
+			// no chain of a dag has more than n tasks
+			bool limited = opts.max_length && opts.max_length < n;
+			std::size_t levels = limited ? opts.max_length : 1;
+			const std::size_t unreachable = n + 1;
+			const Time none = -1;
+
+			// longest[v * levels + l]: largest window requirement of a path
+			// from v to an end task (with at most l + 1 tasks if limited);
+			// to_end[v] and from_start[v]: fewest tasks of a path from v to
+			// an end task and from a start task to v
+			std::vector<Time> longest(n * levels, none);
+			std::vector<std::size_t> to_end(n, unreachable), from_start(n, unreachable);
+
+			for (auto it = order.rbegin(); it != order.rend(); it++) {
+				auto v = *it;
+				// a task adds twice its period (see dag::chain_window_requirement())
+				Time w = 2 * tasks[v]->get_period();
+				const std::size_t *succ = graph.successors(v);
+				std::size_t m = graph.out_degree(v);
+				for (std::size_t l = 0; l < levels; l++) {
+					Time best = is_end[v] ? w : none;
+					if (!limited || l > 0)
+						for (std::size_t k = 0; k < m; k++) {
+							Time rest = longest[succ[k] * levels + (limited ? l - 1 : 0)];
+							if (rest != none)
+								best = std::max(best, w + rest);
+						}
+					longest[v * levels + l] = best;
+				}
+				if (is_end[v])
+					to_end[v] = 1;
+				for (std::size_t k = 0; k < m; k++)
+					if (to_end[succ[k]] != unreachable)
+						to_end[v] = std::min(to_end[v], to_end[succ[k]] + 1);
+			}
+
+			for (auto v: start_tasks)
+				from_start[v] = 1;
+			for (auto v: order) {
+				if (from_start[v] == unreachable)
+					continue;
+				const std::size_t *succ = graph.successors(v);
+				for (std::size_t k = 0, m = graph.out_degree(v); k < m; k++)
+					from_start[succ[k]] = std::min(from_start[succ[k]], from_start[v] + 1);
+			}
+
+			Time window = none;
+			for (auto v: start_tasks)
+				window = std::max(window, longest[v * levels + levels - 1]);
+			if (window == none)
+				return;
+
+			// the tasks that lie on at least one chain
+			std::vector<bool> on_chain(n, false);
+			for (std::size_t v = 0; v < n; v++)
+				if (from_start[v] != unreachable && to_end[v] != unreachable
+					&& (!limited || from_start[v] + to_end[v] - 1 <= opts.max_length))
+					on_chain[v] = true;
+			graph.require_observation_window(window, on_chain);
+		}
+
+		std::size_t number_of_chains_emitted() const
+		{
+			return emitted;
+		}
+
+	private:
+
+		dag<Time> &graph;
+		Chain_enumeration_options opts;
+
+		std::vector<std::size_t> start_tasks;
+		std::vector<bool> is_end;
+
+		// current DFS path (task positions) and, per depth, the next
+		// successor to visit
+		std::vector<bool> on_path;
+		std::vector<std::size_t> path;
+		std::vector<std::size_t> cursor;
+
+		std::size_t next_start;
+		std::size_t emitted;
+
+		void push(std::size_t v)
+		{
+			path.push_back(v);
+			cursor.push_back(0);
+			on_path[v] = true;
+		}
+
+		bool emit(Task_chain &chain)
+		{
+			if (!is_end[path.back()])
+				return false;
+			chain.clear();
+			for (auto v: path)
+				chain.push_back(graph.get_tasks()[v]);
+			emitted++;
+			return true;
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,143 @@
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <csignal>
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+
+namespace NP {
+
+	// What the running exploration is asked to do at its next opportunity.
+	// Set asynchronously, e.g., from a signal handler.
+	enum Checkpoint_request {
+		no_checkpoint_request = 0,
+		checkpoint_and_continue = 1,
+		checkpoint_and_stop = 2
+	};
+
+	inline volatile std::sig_atomic_t& pending_checkpoint_request()
+	{
+		static volatile std::sig_atomic_t request = no_checkpoint_request;
+		return request;
+	}
+
+	class Checkpoint_error : public std::runtime_error
+	{
+	public:
+		Checkpoint_error(const std::string &file, const std::string &what)
+				: std::runtime_error(file + ": " + what)
+		{
+		}
+	};
+
+	// Binary snapshot file. The snapshot is written to a temporary file
+	// first and renamed on commit(), so an interrupted write never
+	// replaces the previous checkpoint.
+	class Checkpoint_writer
+	{
+	public:
+
+		Checkpoint_writer(const std::string &file)
+				: file(file)
+				, tmp_file(file + ".tmp")
+				, out(tmp_file, std::ios::out | std::ios::binary | std::ios::trunc)
+		{
+			if (!out)
+				throw Checkpoint_error(tmp_file, "cannot write checkpoint");
+		}
+
+		template<class T> void write(const T &value)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "raw value expected");
+			out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+
+		template<class T> void write(const std::vector<T> &values)
+		{
+			write<std::uint64_t>(values.size());
+			for (const auto &v : values)
+				write<T>(v);
+		}
+
+		void write(const std::vector<bool> &values)
+		{
+			write<std::uint64_t>(values.size());
+			for (bool v : values)
+				write<std::uint8_t>(v);
+		}
+
+		void commit()
+		{
+			out.close();
+			if (!out || std::rename(tmp_file.c_str(), file.c_str()))
+				throw Checkpoint_error(file, "cannot write checkpoint");
+		}
+
+	private:
+		std::string file, tmp_file;
+		std::ofstream out;
+	};
+
+	class Checkpoint_reader
+	{
+	public:
+
+		Checkpoint_reader(const std::string &file)
+				: file(file)
+				, in(file, std::ios::in | std::ios::binary)
+		{
+		}
+
+		// is there a checkpoint to resume from?
+		bool exists() const
+		{
+			return in.is_open();
+		}
+
+		template<class T> void read(T &value)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "raw value expected");
+			in.read(reinterpret_cast<char*>(&value), sizeof(T));
+			if (!in)
+				throw Checkpoint_error(file, "truncated checkpoint");
+		}
+
+		template<class T> void read(std::vector<T> &values)
+		{
+			std::uint64_t n;
+			read(n);
+			values.resize(n);
+			for (auto &v : values)
+				read(v);
+		}
+
+		void read(std::vector<bool> &values)
+		{
+			std::uint64_t n;
+			read(n);
+			values.resize(n);
+			for (std::size_t i = 0; i < n; i++) {
+				std::uint8_t v;
+				read(v);
+				values[i] = v;
+			}
+		}
+
+		// the checkpoint was written for something else
+		void mismatch(const std::string &what)
+		{
+			throw Checkpoint_error(file, "checkpoint does not match " + what);
+		}
+
+	private:
+		std::string file;
+		std::ifstream in;
+	};
+}
+
+#endif
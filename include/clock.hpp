@@ -2,42 +2,83 @@
 #define CLOCK_HPP
 
 #include <time.h>
+#include <chrono>
+
+// what a Processor_clock measures
+enum class Clock_source {
+	thread_cpu,		// CPU time of the calling thread
+	process_cpu,	// CPU time of the whole process (all threads)
+	wall			// monotonic wall-clock time
+};
 
 class Processor_clock {
 
 	private:
 
-	clock_t accum = 0, start_time = 0;
+	Clock_source source;
+	double accum = 0, start_time = 0;
 	bool running = false;
 
-	static constexpr double scale_to_seconds = 1.0 / (double) CLOCKS_PER_SEC;
+	// current reading of the clock source, in seconds
+	double now() const
+	{
+		if (source == Clock_source::wall) {
+			auto t = std::chrono::steady_clock::now().time_since_epoch();
+			return std::chrono::duration<double>(t).count();
+		}
+#if defined(CLOCK_THREAD_CPUTIME_ID) && defined(CLOCK_PROCESS_CPUTIME_ID)
+		struct timespec ts;
+		clock_gettime(source == Clock_source::thread_cpu
+					  ? CLOCK_THREAD_CPUTIME_ID : CLOCK_PROCESS_CPUTIME_ID, &ts);
+		return ts.tv_sec + ts.tv_nsec * 1E-9;
+#else
+		// no per-thread clock available: fall back to process CPU time
+		return clock() / (double) CLOCKS_PER_SEC;
+#endif
+	}
 
 	public:
 
+	Processor_clock(Clock_source source = Clock_source::thread_cpu)
+			: source(source)
+	{
+	}
+
 	void start()
 	{
 		running = true;
-		start_time = clock();
+		start_time = now();
 	}
 
 
 	double stop()
 	{
-		auto delta = clock() - start_time;
+		auto delta = now() - start_time;
 		if (running) {
 			accum += delta;
 			running = false;
-			return delta * scale_to_seconds;
+			return delta;
 		}
 		else
 			return 0;
 	}
 
 	operator double() const {
-		clock_t extra = 0;
+		double extra = 0;
 		if (running)
-			extra = clock() - start_time;
-		return (accum + extra) * scale_to_seconds;
+			extra = now() - start_time;
+		return accum + extra;
+	}
+
+	// account for time measured before a restart (e.g., of a resumed run)
+	void add(double seconds)
+	{
+		accum += seconds;
+	}
+
+	Clock_source get_source() const
+	{
+		return source;
 	}
 
 };
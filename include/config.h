@@ -5,6 +5,21 @@
 // #define DM(x) std::cerr << x
 #define DM(x)
 
+// branch on a compile-time constant; guaranteed to be discarded with C++17
+#if __cplusplus >= 201703L
+#define NP_IF_CONSTEXPR if constexpr
+#else
+#define NP_IF_CONSTEXPR if
+#endif
+
+// NP_STAT : instrumentation of the exploration engine (counters and
+// timers, see uni/statistics.hpp) -- compiled out unless enabled
+#ifdef CONFIG_COLLECT_STATISTICS
+#define NP_STAT(...) __VA_ARGS__
+#else
+#define NP_STAT(...)
+#endif
+
 #ifndef NDEBUG
 #define TBB_USE_DEBUG 1
 #endif
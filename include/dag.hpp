@@ -6,11 +6,46 @@
 #include <list>
 #include <memory>
 #include <cmath>
-
+#include <algorithm>
+#include <unordered_map>
+#include <set>
+#include <limits>
+#include <exception>
+#include <stdexcept>
+#include <initializer_list>
+
+#include "time.hpp"
 #include "edge.hpp"
 #include "task.hpp"
 
 namespace NP {
+
+	// the hyperperiod or the observation window does not fit into 64 bits
+	class Hyperperiod_overflow : public std::exception {
+	public:
+
+		Hyperperiod_overflow(const std::string &what)
+				: msg(what)
+		{
+		}
+
+		const char *what() const noexcept override
+		{
+			return msg.c_str();
+		}
+
+	private:
+
+		std::string msg;
+	};
+
+	// what makes a task chain the "longest" one
+	enum class Chain_objective {
+		hop_count,	// number of tasks
+		period_sum,	// sum of the task periods
+		wcet_sum	// sum of the task WCETs
+	};
+
 	template<class Time>
 	class dag {
 	public:
@@ -24,30 +59,173 @@ namespace NP {
 //    DAG name
 		std::string name;
 		Task_chains chains;
+		// window requirement and tasks (by position) of chains that are
+		// not stored in `chains`
+		Time required_window = 0;
+		std::vector<bool> on_streamed_chain;
+		// size the observation window by the hyperperiod of the tasks that
+		// can affect the analysed chains instead of the global hyperperiod
+		bool window_bounded_by_chains = false;
+		// one time unit of the (normalised) task parameters, in input units
+		Time time_base = 1;
+
+		// task ID -> position in `tasks`
+		std::unordered_map<unsigned long, std::size_t> task_index;
+
+		// successors of each task (by position) in compressed sparse row form:
+		// the successors of task i are succ_targets[succ_offsets[i] .. succ_offsets[i+1])
+		std::vector<std::size_t> succ_offsets;
+		std::vector<std::size_t> succ_targets;
+		bool adjacency_stale = true;
+
+		void index_last_task() {
+			task_index.emplace(tasks.back()->get_task_id(), tasks.size() - 1);
+			adjacency_stale = true;
+		}
+
+		void build_adjacency() {
+			succ_offsets.assign(tasks.size() + 1, 0);
+			succ_targets.assign(edges.size(), 0);
+
+			for (auto &e: edges) {
+				succ_offsets[index_of_task(e->get_src_task()->get_task_id()) + 1]++;
+			}
+			for (std::size_t i = 0; i < tasks.size(); i++) {
+				succ_offsets[i + 1] += succ_offsets[i];
+			}
+
+			// keep the per-task edge insertion order
+			std::vector<std::size_t> fill(succ_offsets.begin(), succ_offsets.end() - 1);
+			for (auto &e: edges) {
+				auto src = index_of_task(e->get_src_task()->get_task_id());
+				succ_targets[fill[src]++] = index_of_task(e->get_dst_task()->get_task_id());
+			}
+			adjacency_stale = false;
+		}
+
+		// number of windows of length `base` needed to cover the longest
+		// chain requirement, plus one
+		std::size_t number_of_windows(long long base) const {
+			std::size_t ow = ceil((double) required_window / base);
+			for (auto &tc: chains) {
+				std::size_t owTemp = ceil((double) chain_window_requirement(tc) / base);
+				ow = owTemp > ow ? owTemp : ow;
+			}
+			return ow + 1;
+		}
+
+		// LCM of the periods of the tasks that can affect the response time
+		// of a task on an analysed chain: all tasks on the PEs of such tasks
+		// and their predecessors, transitively. Their jobs repeat their
+		// phasing with this period, and only with it.
+		long long chain_window_base() const {
+			std::size_t n = tasks.size();
+			std::vector<bool> affects(on_streamed_chain);
+			affects.resize(n, false);
+			for (auto &tc: chains) {
+				for (auto &t: tc) {
+					affects[index_of_task(t->get_task_id())] = true;
+				}
+			}
+
+			std::vector<std::vector<std::size_t>> preds(n);
+			for (auto &e: edges) {
+				preds[index_of_task(e->get_dst_task()->get_task_id())]
+						.push_back(index_of_task(e->get_src_task()->get_task_id()));
+			}
+
+			std::vector<std::size_t> pending;
+			for (std::size_t v = 0; v < n; v++) {
+				if (affects[v])
+					pending.push_back(v);
+			}
+			auto mark = [&affects, &pending](std::size_t v) {
+				if (!affects[v]) {
+					affects[v] = true;
+					pending.push_back(v);
+				}
+			};
+			std::set<unsigned int> pes;
+			while (!pending.empty()) {
+				auto v = pending.back();
+				pending.pop_back();
+				for (auto p: preds[v])
+					mark(p);
+				if (pes.insert(tasks[v]->get_pe()).second) {
+					for (std::size_t w = 0; w < n; w++) {
+						if (tasks[w]->get_pe() == tasks[v]->get_pe())
+							mark(w);
+					}
+				}
+			}
+
+			long long base = 1;
+			for (std::size_t v = 0; v < n; v++) {
+				if (affects[v])
+					base = lcm(base, tasks[v]->get_period());
+			}
+			return base;
+		}
+
+		template<class Other>
+		friend class dag;
 
 	public:
 		dag() {
 
 		}
 
+		// a copy of a dag with another time type (all of whose timing
+		// parameters must fit into Time), including its chains and window
+		template<class Other>
+		explicit dag(const dag<Other> &other)
+				: hyperperiod(other.hyperperiod)
+				, name(other.name)
+				, required_window((Time) other.required_window)
+				, on_streamed_chain(other.on_streamed_chain)
+				, window_bounded_by_chains(other.window_bounded_by_chains)
+				, time_base((Time) other.time_base)
+		{
+			for (auto &t: other.tasks) {
+				add_task(t->get_task_id(), (Time) t->get_bcet(), (Time) t->get_wcet(), (Time) t->get_period(),
+						 Interval<Time>{(Time) t->min_jitter(), (Time) t->max_jitter()},
+						 (Time) t->get_deadline(), t->get_pe());
+			}
+			// in the same order, so that successors are visited in the same order
+			for (auto &e: other.edges) {
+				add_edge(e->get_src_task()->get_task_id(), e->get_dst_task()->get_task_id());
+			}
+			for (auto &tc: other.chains) {
+				Task_chain chain;
+				for (auto &t: tc) {
+					chain.push_back(find_task(t->get_task_id()));
+				}
+				add_task_chain(chain);
+			}
+		}
+
 		void add_task(std::shared_ptr<Task<Time>> &t) {
 			tasks.push_back(t);
+			index_last_task();
 		}
 
 		void add_task(unsigned long tid, Time bcet, Time wcet, Time period, Interval<Time> jitter, Time deadline,
 					  unsigned int PE) {
 			tasks.emplace_back(std::make_shared<Task<Time>>
 									   (tid, bcet, wcet, period, jitter, deadline, PE));
+			index_last_task();
 		}
 
 		void add_task(unsigned long tid, Time bcet, Time wcet, Time rec_cost_min, Time rec_cost_max, Time period, Interval<Time> jitter, Time deadline,
 					  unsigned int PE) {
 			tasks.emplace_back(std::make_shared<Task<Time>>
 									   (tid, bcet, wcet, rec_cost_min, rec_cost_max, period, jitter, deadline, PE));
+			index_last_task();
 		}
 
 		void add_edge(std::shared_ptr<Edge<Task<Time>>> &e) {
 			edges.push_back(e);
+			adjacency_stale = true;
 		}
 
 		void add_edge(unsigned long source_task, unsigned long destination_task) {
@@ -58,6 +236,7 @@ namespace NP {
 			edges.emplace_back(std::make_shared<Edge<Task<Time>>>(srcT, desT));
 			srcT->add_snd_edges(edges.back());
 			desT->add_rcv_edges(edges.back());
+			adjacency_stale = true;
 
 		}
 
@@ -65,6 +244,10 @@ namespace NP {
 			return tasks;
 		}
 
+		const std::vector<std::shared_ptr<Task<Time>>> &get_tasks() const {
+			return tasks;
+		}
+
 		std::vector<std::shared_ptr<Edge<Task<Time>>>> &get_edges() {
 			return edges;
 		}
@@ -89,36 +272,113 @@ namespace NP {
 		}
 
 		std::shared_ptr<Task<Time>> &find_task(unsigned long id) {
-			for (auto &t: tasks) {
-				if (t->get_task_id() == id)
-					return t;
+			return tasks[index_of_task(id)];
+		}
+
+		std::size_t index_of_task(unsigned long id) const {
+			auto it = task_index.find(id);
+			if (it == task_index.end()) {
+				std::cerr << "Invalid TaskID => " << id << std::endl;
+				exit(1);
 			}
-			std::cerr << "Invalid TaskID => " << id << std::endl;
-			exit(1);
+			return it->second;
+		}
+
+		// number of successors of the task at position idx
+		std::size_t out_degree(std::size_t idx) {
+			if (adjacency_stale)
+				build_adjacency();
+			return succ_offsets[idx + 1] - succ_offsets[idx];
+		}
+
+		// pointer to the first successor (by position) of the task at position idx
+		const std::size_t *successors(std::size_t idx) {
+			if (adjacency_stale)
+				build_adjacency();
+			return succ_targets.data() + succ_offsets[idx];
 		}
 
 		void set_hyperperiod(Time h) {
 			hyperperiod = h;
 		}
 
-		Time get_hyperperiod() {
+		Time get_hyperperiod() const {
 			return hyperperiod;
 		}
 
 
 		// Recursive function to return gcd of a and b
-		long long gcd(long long int a, long long int b) {
+		static long long gcd(long long int a, long long int b) {
 			if (b == 0)
 				return a;
 			return gcd(b, a % b);
 		}
 
-		// Function to return LCM of two numbers
-		long long lcm(long long a, long long b) {
-			return (a / gcd(a, b)) * b;
+		// Function to return LCM of two numbers; throws Hyperperiod_overflow
+		// if the result does not fit into a long long
+		static long long lcm(long long a, long long b) {
+			return checked_mul(a / gcd(a, b), b, "hyperperiod");
+		}
+
+		// a * b for non-negative a and b, computed in 128 bits where available
+		static long long checked_mul(long long a, long long b, const char *what) {
+#ifdef __SIZEOF_INT128__
+			__int128 p = (__int128) a * b;
+			if (p > std::numeric_limits<long long>::max())
+#else
+			if (b != 0 && a > std::numeric_limits<long long>::max() / b)
+#endif
+				throw Hyperperiod_overflow(std::string(what) + " overflows 64 bits ("
+										   + std::to_string(a) + " * " + std::to_string(b) + ")");
+			return a * b;
 		}
 
 
+		// Divides all timing parameters by a common time base and returns the
+		// resulting time base (in input units). Without a quantum the base is
+		// the GCD of all parameters, so the model is unchanged up to scaling
+		// (non-integral dense parameters are left alone). With a quantum, the
+		// periods must be multiples of it; BCETs, minimal jitter and deadlines
+		// are rounded down and WCETs and maximal jitter up.
+		// Must be called before the hyperperiod and the chains are computed.
+		Time normalize_time_base(Time quantum = 0) {
+			if (quantum <= 0) {
+				long long g = 0;
+				for (auto &t: tasks) {
+					for (Time v: {t->get_bcet(), t->get_wcet(), t->get_period(),
+								  t->min_jitter(), t->max_jitter(), t->get_deadline()}) {
+						if ((Time) (long long) v != v)
+							return time_base;
+						g = gcd(g, (long long) v);
+					}
+				}
+				if (g <= 1)
+					return time_base;
+				quantum = g;
+			} else {
+				for (auto &t: tasks) {
+					if (Time_model::quanta_below(t->get_period(), quantum) * quantum != t->get_period())
+						throw std::invalid_argument("period of task " + std::to_string(t->get_task_id())
+													+ " is not a multiple of the time quantum");
+				}
+			}
+
+			for (auto &t: tasks) {
+				t->set_timing(Time_model::quanta_below(t->get_bcet(), quantum),
+							  Time_model::quanta_above(t->get_wcet(), quantum),
+							  Time_model::quanta_below(t->get_period(), quantum),
+							  Interval<Time>{Time_model::quanta_below(t->min_jitter(), quantum),
+											 Time_model::quanta_above(t->max_jitter(), quantum)},
+							  Time_model::quanta_below(t->get_deadline(), quantum));
+			}
+			time_base *= quantum;
+			return time_base;
+		}
+
+		Time get_time_base() const {
+			return time_base;
+		}
+
 		//Function to calculate hyperperiod
 		void calculate_hyperperiod() {
 			long long h = 1;
@@ -128,7 +388,8 @@ namespace NP {
 			set_hyperperiod(h);
 		}
 
-		long long get_number_of_jobs() {
+		// number of jobs released in one hyperperiod
+		long long get_number_of_jobs() const {
 			long long nj = 0;
 			for (auto &t: get_tasks()) {
 				nj += get_hyperperiod() / t->get_period();
@@ -136,6 +397,15 @@ namespace NP {
 			return nj;
 		}
 
+		// number of jobs released in [0, window)
+		long long get_number_of_jobs(Time window) const {
+			long long nj = 0;
+			for (auto &t: get_tasks()) {
+				nj += (long long) ceil((double) window / t->get_period());
+			}
+			return nj;
+		}
+
 		std::vector<std::shared_ptr<Task<Time>>> get_source_tasks() {
 			std::vector<std::shared_ptr<Task<Time>>> temp;
 			for (auto &&i: tasks) {
@@ -166,61 +436,49 @@ namespace NP {
 		}
 
 		Task_chains find_all_paths(std::shared_ptr<Task<Time>> source, std::shared_ptr<Task<Time>> dist) {
-			int s, d;
 			Task_chains vec;
-			s = source->get_task_id();
-			d = dist->get_task_id();
-			// Mark all the vertices as not visited
-			bool *visited = new bool[tasks.size()];
+			std::size_t s = index_of_task(source->get_task_id());
+			std::size_t d = index_of_task(dist->get_task_id());
 
-			// Create an array to store paths
-			int *path = new int[tasks.size()];
-			int path_index = 0; // Initialize path[] as empty
+			// Mark all the vertices as not visited
+			std::vector<bool> visited(tasks.size(), false);
 
-			// Initialize all vertices as not visited
-			for (int i = 0; i < tasks.size(); i++)
-				visited[i] = false;
+			// Positions of the tasks on the current path
+			std::vector<std::size_t> path;
+			path.reserve(tasks.size());
 
-			// Call the recursive helper function to print all paths
-			find_all_paths_util(s, d, visited, path, path_index, vec);
+			find_all_paths_util(s, d, visited, path, vec);
 			return vec;
 		}
 
-		// A recursive function to find all paths from 'u' (label) to 'd' (label).
-		// Visited[] keeps track of vertices in the current path.
-		// Path[] stores actual vertices and path_index is current
-		// index in path[]
-		void find_all_paths_util(int u, int d, bool visited[],
-								 int path[], int &path_index, Task_chains &vec) {
+		// A recursive function to find all paths from 'u' to 'd' (both
+		// positions in `tasks`). Visited[] keeps track of vertices in the
+		// current path, which is stored in path[].
+		void find_all_paths_util(std::size_t u, std::size_t d, std::vector<bool> &visited,
+								 std::vector<std::size_t> &path, Task_chains &vec) {
 			// Mark the current node and store it in path[]
 			visited[u] = true;
-			path[path_index] = u;
-			path_index++;
+			path.push_back(u);
 
-			// If current vertex is same as destination, then print
+			// If current vertex is same as destination, then store the
 			// current path[]
 			if (u == d) {
 				Task_chain temp;
-				for (int i = 0; i < path_index; i++) {
-					temp.push_back(find_task(path[i]));
+				temp.reserve(path.size());
+				for (auto i: path) {
+					temp.push_back(tasks[i]);
 				}
 				vec.push_back(temp);
-
 			}
 
-
-			// std::cout<<findTask("T"+std::to_string(u+1)).getSndEdges();
-			for (auto &&j: find_task(u)->get_snd_edges()) {
-
-				int i;
-				i = j->get_dst_task()->get_task_id();
-				if (!visited[i])
-					find_all_paths_util(i, d, visited, path, path_index, vec);
+			const std::size_t *succ = successors(u);
+			for (std::size_t k = 0, n = out_degree(u); k < n; k++) {
+				if (!visited[succ[k]])
+					find_all_paths_util(succ[k], d, visited, path, vec);
 			}
 
-
 			// Remove current vertex from path[] and mark it as unvisited
-			path_index--;
+			path.pop_back();
 			visited[u] = false;
 		}
 
@@ -238,42 +496,183 @@ namespace NP {
 			}
 		}
 
-		void find_longest_task_chain() {
-			Task_chain temp;
-			for (auto &t1: get_source_tasks()) {
-				for (auto &t2: get_sink_tasks()) {
-					Task_chains temp1 = find_all_paths(t1, t2);
-					if(!temp1.empty()) {
-						if(temp.empty()) {
-							temp = temp1[0];
-						}
-						for (auto &t: temp1) {
-							if (t.size() > temp.size()) {
-								temp = t;
-							}
-						}
-					}
-				}
+		// Positions of all tasks in a topological order (Kahn's algorithm)
+		std::vector<std::size_t> topological_task_order() {
+			std::size_t n = tasks.size();
+			std::vector<std::size_t> in_degree(n, 0);
+			for (std::size_t v = 0; v < n; v++) {
+				const std::size_t *succ = successors(v);
+				for (std::size_t k = 0, m = out_degree(v); k < m; k++)
+					in_degree[succ[k]]++;
+			}
+
+			std::vector<std::size_t> order;
+			order.reserve(n);
+			for (std::size_t v = 0; v < n; v++)
+				if (in_degree[v] == 0)
+					order.push_back(v);
+
+			for (std::size_t head = 0; head < order.size(); head++) {
+				auto v = order[head];
+				const std::size_t *succ = successors(v);
+				for (std::size_t k = 0, m = out_degree(v); k < m; k++)
+					if (--in_degree[succ[k]] == 0)
+						order.push_back(succ[k]);
+			}
 
+			if (order.size() != n) {
+				std::cerr << "The task graph contains a cycle" << std::endl;
+				exit(1);
 			}
+			return order;
+		}
+
+		// Select the source-to-sink chain that maximises the given objective
+		// with a single dynamic program over a topological order, i.e., in
+		// O(tasks + edges). Ties are broken like an exhaustive enumeration
+		// over (source, sink, DFS path) would: first source, then first sink,
+		// then first successor in edge order.
+		void find_longest_task_chain(Chain_objective objective = Chain_objective::hop_count) {
+			std::size_t n = tasks.size();
+			auto order = topological_task_order();
+
+			// best[v]: best objective value of a chain from v to any sink
+			std::vector<Time> best(n);
+			std::vector<std::size_t> sink_of(n), next(n, n);
+			std::vector<bool> has_pred(n, false);
+
+			for (auto it = order.rbegin(); it != order.rend(); it++) {
+				auto v = *it;
+				const std::size_t *succ = successors(v);
+				std::size_t chosen = n;
+				for (std::size_t k = 0, m = out_degree(v); k < m; k++) {
+					auto w = succ[k];
+					has_pred[w] = true;
+					if (chosen == n || best[w] > best[chosen]
+						|| (best[w] == best[chosen] && sink_of[w] < sink_of[chosen]))
+						chosen = w;
+				}
+				if (chosen == n) {
+					best[v] = chain_weight(*tasks[v], objective);
+					sink_of[v] = v;
+				} else {
+					best[v] = chain_weight(*tasks[v], objective) + best[chosen];
+					sink_of[v] = sink_of[chosen];
+					next[v] = chosen;
+				}
+			}
+
+			std::size_t start = n;
+			for (std::size_t v = 0; v < n; v++)
+				if (!has_pred[v] && (start == n || best[v] > best[start]))
+					start = v;
+
+			Task_chain temp;
+			for (auto v = start; v != n; v = next[v])
+				temp.push_back(tasks[v]);
 			add_task_chain(temp);
 		}
 
+		static Time chain_weight(const Task<Time> &t, Chain_objective objective) {
+			switch (objective) {
+				case Chain_objective::period_sum:
+					return t.get_period();
+				case Chain_objective::wcet_sum:
+					return t.get_wcet();
+				default:
+					return 1;
+			}
+		}
+
 		Task_chains &get_task_chains() {
 			return chains;
 		}
 
-		std::size_t get_number_hp_observation_window() {
-			std::size_t ow = 0;
-			for (auto tc: get_task_chains()) {
-				Time wct = 0;
-				for (auto t: tc) {
-					wct += 2 * t->get_period();
-				}
-				std::size_t owTemp = ceil((double) wct / get_hyperperiod());
-				ow = owTemp > ow ? owTemp : ow;
+		const Task_chains &get_task_chains() const {
+			return chains;
+		}
+
+		// length of the observation window needed to analyse a chain
+		static Time chain_window_requirement(const Task_chain &tc) {
+			Time wct = 0;
+			for (auto &t: tc) {
+				wct += 2 * t->get_period();
 			}
-			return ow + 1;
+			return wct;
+		}
+
+		// account for a chain that is analysed without being stored (e.g.,
+		// when chains are enumerated lazily)
+		void require_observation_window(const Task_chain &tc) {
+			required_window = std::max(required_window, chain_window_requirement(tc));
+			on_streamed_chain.resize(tasks.size(), false);
+			for (auto &t: tc) {
+				on_streamed_chain[index_of_task(t->get_task_id())] = true;
+			}
+		}
+
+		// the same for a set of such chains, given their largest window
+		// requirement and which tasks (by position) lie on them
+		void require_observation_window(Time window, const std::vector<bool> &on_chain) {
+			required_window = std::max(required_window, window);
+			on_streamed_chain.resize(tasks.size(), false);
+			for (std::size_t v = 0; v < on_chain.size(); v++) {
+				if (on_chain[v])
+					on_streamed_chain[v] = true;
+			}
+		}
+
+		// if set, the observation window is a multiple of the LCM of the
+		// periods of the tasks that can affect the analysed chains (see
+		// chain_window_base()); tasks on other PEs that precede no such
+		// task no longer inflate it
+		void bound_window_by_chains(bool bounded) {
+			window_bounded_by_chains = bounded;
+		}
+
+		// true if the observation window is bounded by chains and there are
+		// chains to bound it; then the hyperperiod of all tasks is not needed
+		// (and need not be calculated)
+		bool has_chain_bounded_window() const {
+			if (!window_bounded_by_chains)
+				return false;
+			if (required_window > 0)
+				return true;
+			for (auto &tc: get_task_chains())
+				if (!tc.empty())
+					return true;
+			return false;
+		}
+
+		std::size_t get_number_hp_observation_window() const {
+			return number_of_windows(get_hyperperiod());
+		}
+
+		// upper bound on every finish time and absolute deadline of the jobs
+		// in the observation window: all of them are released by the end of
+		// the window plus the largest jitter, and a work-conserving schedule
+		// finishes them within their total WCET
+		long long get_time_horizon() const {
+			long long window = get_observation_window();
+			long long horizon = window;
+			long long max_jitter = 0, max_deadline = 0;
+			for (auto &t: tasks) {
+				long long n = (long long) ceil((double) window / t->get_period());
+				horizon += checked_mul(n, (long long) ceil(t->get_wcet()), "time horizon");
+				max_jitter = std::max(max_jitter, (long long) ceil(t->max_jitter()));
+				max_deadline = std::max(max_deadline, (long long) ceil(t->get_deadline()));
+			}
+			return horizon + std::max(max_jitter, max_deadline);
+		}
+
+		// length of the interval in which jobs are generated
+		Time get_observation_window() const {
+			long long base = get_hyperperiod();
+			// the LCM of the periods of the affecting tasks divides the
+			// hyperperiod
+			if (has_chain_bounded_window())
+				base = chain_window_base();
+			return checked_mul(number_of_windows(base), base, "observation window");
 		}
 
 		Time get_chain_hyperperiod(std::size_t index) {
@@ -0,0 +1,272 @@
+#ifndef GENERATOR_HPP
+#define GENERATOR_HPP
+
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <stdexcept>
+
+#include "dag.hpp"
+
+namespace NP {
+
+	// Candidate periods (in the time unit of the generated tasks,
+	// microseconds) and how likely each of them is.
+	struct Period_distribution {
+		std::vector<long long> periods;
+		// relative weights, aligned with `periods` (empty means uniform)
+		std::vector<double> weights;
+	};
+
+	// Named period distributions: "harmonic", "loose", "automotive" (the
+	// periods of automotive benchmark applications, Kramer et al., WATERS
+	// 2015, with their shares of the runnables), and "automotive-uniform"
+	// (the same periods, each equally likely).
+	inline Period_distribution period_distribution(const std::string &name)
+	{
+		if (name == "harmonic")
+			return {{10000, 20000, 40000, 80000, 160000}, {}};
+		if (name == "loose")
+			return {{10000, 20000, 50000, 100000}, {}};
+		if (name == "automotive")
+			return {{1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000, 1000000},
+					{3, 2, 2, 25, 25, 3, 20, 1, 4}};
+		if (name == "automotive-uniform")
+			return {{1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000, 1000000}, {}};
+		throw std::invalid_argument("unknown period distribution: " + name);
+	}
+
+	// how the utilisation of a PE is divided among its tasks
+	enum class Utilization_split {
+		uunifast,	// UUniFast (Bini and Buttazzo), unbiased
+		uniform		// proportional to uniformly drawn weights
+	};
+
+	// how the tasks are connected
+	enum class Dag_shape {
+		random,		// edge i -> j (i < j) with the given probability
+		layered		// tasks in layers; edges only between adjacent layers
+	};
+
+	// which PE a task is mapped to
+	enum class Pe_mapping {
+		round_robin,	// task i to PE i mod #PEs
+		random			// uniformly at random (every PE gets one task at least)
+	};
+
+	// Shape of a synthetic task set
+	struct Workload_parameters {
+		unsigned int num_tasks = 20;
+		unsigned int num_pes = 2;
+		Pe_mapping mapping = Pe_mapping::round_robin;
+		// total utilisation of each PE, unless given per PE
+		double utilization = 0.5;
+		std::vector<double> pe_utilization;
+		Utilization_split split = Utilization_split::uunifast;
+		Period_distribution periods = period_distribution("harmonic");
+		// release jitter, as a fraction of the period
+		double jitter = 0.01;
+		// BCET, as a fraction of the WCET
+		double bcet_ratio = 0.1;
+		Dag_shape shape = Dag_shape::random;
+		// number of layers of a layered dag (zero means chain_length)
+		unsigned int num_layers = 0;
+		// probability of an edge between two tasks (that may be connected)
+		double edge_probability = 0.05;
+		// number of cause-effect chains and their number of tasks
+		unsigned int num_chains = 1;
+		unsigned int chain_length = 4;
+		std::uint64_t seed = 1;
+
+		double utilization_of_pe(unsigned int pe) const
+		{
+			return pe < pe_utilization.size() ? pe_utilization[pe] : utilization;
+		}
+	};
+
+	// Small deterministic random number generator (splitmix64), so that
+	// a seed yields the same task set with every compiler and library.
+	class Workload_random
+	{
+	public:
+
+		Workload_random(std::uint64_t seed) : state(seed) {}
+
+		std::uint64_t next()
+		{
+			std::uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+			return z ^ (z >> 31);
+		}
+
+		// uniform in [0, 1)
+		double unit()
+		{
+			return (next() >> 11) * (1.0 / 9007199254740992.0);
+		}
+
+		// uniform in [0, n)
+		std::size_t below(std::size_t n)
+		{
+			return next() % n;
+		}
+
+		// index drawn with the given relative weights (uniform if empty)
+		std::size_t weighted(std::size_t n, const std::vector<double> &weights)
+		{
+			if (weights.empty())
+				return below(n);
+			double total = 0;
+			for (std::size_t i = 0; i < n; i++)
+				total += weights[i];
+			double x = unit() * total;
+			for (std::size_t i = 0; i < n; i++) {
+				if (x < weights[i])
+					return i;
+				x -= weights[i];
+			}
+			return n - 1;
+		}
+
+	private:
+		std::uint64_t state;
+	};
+
+	// utilisations of n tasks that add up to u
+	inline std::vector<double> split_utilization(std::size_t n, double u, Utilization_split how,
+												 Workload_random &rng)
+	{
+		std::vector<double> shares(n);
+		if (how == Utilization_split::uunifast) {
+			double rest = u;
+			for (std::size_t i = 0; i + 1 < n; i++) {
+				double next = rest * std::pow(rng.unit(), 1.0 / (n - i - 1));
+				shares[i] = rest - next;
+				rest = next;
+			}
+			if (n)
+				shares[n - 1] = rest;
+		} else {
+			double total = 0;
+			for (auto &s : shares)
+				total += (s = 0.1 + rng.unit());
+			for (auto &s : shares)
+				s *= u / total;
+		}
+		return shares;
+	}
+
+	// Random task set of the given shape. Task IDs follow a topological
+	// order of the task graph, and the cause-effect chains are paths in
+	// it; deadlines are implicit. The hyperperiod is not calculated, as
+	// writing the task set does not need it.
+	template<class Time>
+	dag<Time> generate_dag(const Workload_parameters &p)
+	{
+		if (!p.num_tasks || !p.num_pes || p.periods.periods.empty())
+			throw std::invalid_argument("empty workload");
+		if (p.num_tasks < p.num_pes)
+			throw std::invalid_argument("fewer tasks than PEs");
+		for (long long period : p.periods.periods)
+			if (period <= 0)
+				throw std::invalid_argument("periods must be positive");
+
+		Workload_random rng(p.seed);
+		dag<Time> g;
+
+		// map the tasks, then divide the utilisation of each PE
+		std::vector<unsigned int> pe_of(p.num_tasks);
+		for (unsigned int i = 0; i < p.num_tasks; i++)
+			pe_of[i] = i % p.num_pes;
+		if (p.mapping == Pe_mapping::random) {
+			for (unsigned int i = p.num_pes; i < p.num_tasks; i++)
+				pe_of[i] = rng.below(p.num_pes);
+			for (unsigned int i = 0; i < p.num_tasks; i++)
+				std::swap(pe_of[i], pe_of[i + rng.below(p.num_tasks - i)]);
+		}
+
+		std::vector<std::vector<unsigned int>> tasks_of_pe(p.num_pes);
+		for (unsigned int i = 0; i < p.num_tasks; i++)
+			tasks_of_pe[pe_of[i]].push_back(i);
+
+		std::vector<double> u(p.num_tasks);
+		for (unsigned int pe = 0; pe < p.num_pes; pe++) {
+			auto shares = split_utilization(tasks_of_pe[pe].size(), p.utilization_of_pe(pe), p.split, rng);
+			for (std::size_t k = 0; k < shares.size(); k++)
+				u[tasks_of_pe[pe][k]] = shares[k];
+		}
+
+		for (unsigned int i = 0; i < p.num_tasks; i++) {
+			const auto &ps = p.periods.periods;
+			long long period = ps[rng.weighted(ps.size(), p.periods.weights)];
+			Time wcet = std::max<long long>(1, (long long) (u[i] * period));
+			Time bcet = std::max<long long>(1, (long long) (p.bcet_ratio * wcet));
+			g.add_task(i, std::min(bcet, wcet), wcet, (Time) period,
+					   Interval<Time>{0, (Time) (long long) (p.jitter * period)}, (Time) period, pe_of[i]);
+		}
+
+		// layer of each task (all in one layer for the random shape)
+		unsigned int num_layers = p.shape == Dag_shape::layered
+								  ? std::max(1u, std::min(p.num_layers ? p.num_layers : p.chain_length, p.num_tasks))
+								  : 1;
+		std::vector<unsigned int> layer_of(p.num_tasks);
+		std::vector<std::vector<unsigned long>> layer(num_layers);
+		for (unsigned int i = 0; i < p.num_tasks; i++) {
+			layer_of[i] = (unsigned long long) i * num_layers / p.num_tasks;
+			layer[layer_of[i]].push_back(i);
+		}
+
+		std::set<std::pair<unsigned long, unsigned long>> edges;
+		auto connect = [&g, &edges](unsigned long from, unsigned long to) {
+			if (edges.emplace(from, to).second)
+				g.add_edge(from, to);
+		};
+
+		// the chains: increasing task IDs, one task per layer if layered
+		for (unsigned int c = 0; c < p.num_chains; c++) {
+			std::vector<unsigned long> members;
+			if (p.shape == Dag_shape::layered) {
+				for (unsigned int l = 0; l < std::min(p.chain_length, num_layers); l++)
+					members.push_back(layer[l][rng.below(layer[l].size())]);
+			} else {
+				std::vector<unsigned long> all(p.num_tasks);
+				for (unsigned int i = 0; i < p.num_tasks; i++)
+					all[i] = i;
+				for (unsigned int i = 0; i < p.num_tasks; i++)
+					std::swap(all[i], all[i + rng.below(p.num_tasks - i)]);
+				members.assign(all.begin(), all.begin() + std::min(p.chain_length, p.num_tasks));
+				std::sort(members.begin(), members.end());
+			}
+			if (members.size() < 2)
+				continue;
+
+			typename dag<Time>::Task_chain chain;
+			for (std::size_t k = 0; k < members.size(); k++) {
+				if (k)
+					connect(members[k - 1], members[k]);
+				chain.push_back(g.find_task(members[k]));
+			}
+			g.add_task_chain(chain);
+		}
+
+		for (unsigned long i = 0; i < p.num_tasks; i++) {
+			if (p.shape == Dag_shape::random) {
+				for (unsigned long j = i + 1; j < p.num_tasks; j++)
+					if (rng.unit() < p.edge_probability)
+						connect(i, j);
+			} else if (layer_of[i] + 1 < num_layers) {
+				for (unsigned long j : layer[layer_of[i] + 1])
+					if (rng.unit() < p.edge_probability)
+						connect(i, j);
+			}
+		}
+
+		return g;
+	}
+}
+
+#endif
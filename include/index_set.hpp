@@ -1,50 +1,70 @@
 #ifndef INDEX_SET_H
 #define INDEX_SET_H
 
+#include <vector>
+#include <cstdint>
+#include <ostream>
+#include <algorithm>
+#include <utility>
+
 namespace NP {
 
 	class Index_set
 	{
 	public:
 
-		typedef std::vector<bool> Set_type;
+		typedef std::uint64_t Word;
+		typedef std::vector<Word> Set_type;
+
+		static constexpr std::size_t bits_per_word = 64;
 
 		// new empty job set
 		Index_set() : the_set() {}
 
+		// set with the given words (e.g., read back from disk)
+		explicit Index_set(Set_type words) : the_set(std::move(words)) {}
+
 		// derive a new set by "cloning" an existing set and adding an index
 		Index_set(const Index_set& from, std::size_t idx)
-				: the_set(std::max(from.the_set.size(), idx + 1))
+				: the_set(std::max(from.the_set.size(), word_of(idx) + 1))
 		{
 			std::copy(from.the_set.begin(), from.the_set.end(), the_set.begin());
-			the_set[idx] = true;
+			the_set[word_of(idx)] |= bit_of(idx);
 		}
 
 		// create the diff of two job sets (intended for debugging only)
 		Index_set(const Index_set &a, const Index_set &b)
-				: the_set(std::max(a.the_set.size(), b.the_set.size()), true)
+				: the_set(std::max(a.the_set.size(), b.the_set.size()), ~Word(0))
 		{
 			auto limit = std::min(a.the_set.size(), b.the_set.size());
-			for (unsigned int i = 0; i < limit; i++)
-				the_set[i] = a.contains(i) ^ b.contains(i);
+			for (std::size_t i = 0; i < limit; i++)
+				the_set[i] = a.the_set[i] ^ b.the_set[i];
 		}
 
 		bool operator==(const Index_set &other) const
 		{
-			return the_set == other.the_set;
+			// trailing zero words do not change the contents of a set
+			const Set_type &shorter = the_set.size() < other.the_set.size() ? the_set : other.the_set;
+			const Set_type &longer = the_set.size() < other.the_set.size() ? other.the_set : the_set;
+			if (!std::equal(shorter.begin(), shorter.end(), longer.begin()))
+				return false;
+			for (std::size_t i = shorter.size(); i < longer.size(); i++)
+				if (longer[i])
+					return false;
+			return true;
 		}
 
 		bool operator!=(const Index_set &other) const
 		{
-			return the_set != other.the_set;
+			return !(*this == other);
 		}
 
 		bool contains(std::size_t idx) const
 		{
-			return the_set.size() > idx && the_set[idx];
+			return the_set.size() > word_of(idx) && (the_set[word_of(idx)] & bit_of(idx));
 		}
 
-		bool includes(std::vector<std::size_t> indices) const
+		bool includes(const std::vector<std::size_t> &indices) const
 		{
 			for (auto i : indices)
 				if (!contains(i))
@@ -54,26 +74,51 @@ namespace NP {
 
 		bool is_subset_of(const Index_set& other) const
 		{
-			for (unsigned int i = 0; i < the_set.size(); i++)
-				if (contains(i) && !other.contains(i))
+			for (std::size_t i = 0; i < the_set.size(); i++) {
+				Word o = i < other.the_set.size() ? other.the_set[i] : 0;
+				if (the_set[i] & ~o)
 					return false;
+			}
 			return true;
 		}
 
+		// the words of the set, without trailing zero words
+		Set_type words() const
+		{
+			auto n = the_set.size();
+			while (n && !the_set[n - 1])
+				n--;
+			return Set_type(the_set.begin(), the_set.begin() + n);
+		}
+
+		// bytes held on the heap by this set
+		std::size_t heap_bytes() const
+		{
+			return the_set.capacity() * sizeof(Word);
+		}
+
 		std::size_t size() const
 		{
 			std::size_t count = 0;
-			for (auto x : the_set)
-				if (x)
-					count++;
+			for (auto w : the_set)
+				count += popcount(w);
 			return count;
 		}
 
 		void add(std::size_t idx)
 		{
-			if (idx >= the_set.size())
-				the_set.resize(idx + 1);
-			the_set[idx] = true;
+			if (word_of(idx) >= the_set.size())
+				the_set.resize(word_of(idx) + 1);
+			the_set[word_of(idx)] |= bit_of(idx);
+		}
+
+		// set union, word by word
+		void add(const Index_set& other)
+		{
+			if (other.the_set.size() > the_set.size())
+				the_set.resize(other.the_set.size());
+			for (std::size_t i = 0; i < other.the_set.size(); i++)
+				the_set[i] |= other.the_set[i];
 		}
 
 		friend std::ostream& operator<< (std::ostream& stream,
@@ -81,8 +126,8 @@ namespace NP {
 		{
 			bool first = true;
 			stream << "{";
-			for (auto i = 0; i < s.the_set.size(); i++)
-				if (s.the_set[i]) {
+			for (std::size_t i = 0; i < s.the_set.size() * bits_per_word; i++)
+				if (s.contains(i)) {
 					if (!first)
 						stream << ", ";
 					first = false;
@@ -97,9 +142,31 @@ namespace NP {
 
 		Set_type the_set;
 
+		static std::size_t word_of(std::size_t idx)
+		{
+			return idx / bits_per_word;
+		}
+
+		static Word bit_of(std::size_t idx)
+		{
+			return Word(1) << (idx % bits_per_word);
+		}
+
+		static std::size_t popcount(Word w)
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			return __builtin_popcountll(w);
+#else
+			std::size_t count = 0;
+			for (; w; w &= w - 1)
+				count++;
+			return count;
+#endif
+		}
+
 		// no accidental copies
 		// Index_set(const Index_set& origin) = delete;
 	};
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -3,6 +3,8 @@
 
 #include <iostream>
 #include <utility>
+#include <vector>
+#include <algorithm>
 
 #include "interval.hpp"
 #include "time.hpp"
@@ -90,23 +92,77 @@ namespace NP {
 	}
 
 
-	// function to generate job set out of a dag with given hyperperiod
-	template<class Time> typename Job<Time>::Job_set generate_job_set(typename NP::dag<Time> dag) {
+	// write a dag (and its task chains) in the format read by parse_mr_dag()
+	// and parse_task_chain()
+	template<class Time>
+	void write_mr_dag(std::ostream &out, NP::dag<Time> &dag) {
+		out << "vertexset:\n";
+		for (auto &t: dag.get_tasks()) {
+			out << "  - TaskID: " << t->get_task_id() << "\n"
+				<< "    VertexID: " << t->get_task_id() << "\n"
+				<< "    Jitter: " << t->max_jitter() << "\n"
+				<< "    BCET: " << t->get_bcet() << "\n"
+				<< "    WCET: " << t->get_wcet() << "\n"
+				<< "    Period: " << t->get_period() << "\n"
+				<< "    Deadline: " << t->get_deadline() << "\n"
+				<< "    PE: " << t->get_pe() << "\n"
+				<< "    Successors: [";
+			bool first = true;
+			for (auto &e: t->get_snd_edges()) {
+				out << (first ? "" : ",") << e->get_dst_task()->get_task_id();
+				first = false;
+			}
+			out << "]\n";
+		}
+		if (dag.get_task_chains().empty())
+			return;
+		out << "\ntaskchains:\n";
+		for (auto &tc: dag.get_task_chains()) {
+			out << "  - Chain: [";
+			for (std::size_t i = 0; i < tc.size(); i++)
+				out << (i ? "," : "") << tc[i]->get_task_id();
+			out << "]\n";
+		}
+	}
+
+	// Jobs generated from a dag: the global job set (task by task, in
+	// release order within each task) and, for each PE, the positions of
+	// its jobs in the global set sorted by earliest release.
+	template<class Time> struct Generated_jobs {
 		typename Job<Time>::Job_set jobs;
-		auto tasks = dag.get_tasks();
-		dag.calculate_hyperperiod();
-		auto hyperperiod = dag.get_hyperperiod();
-		auto observation_window = dag.get_number_hp_observation_window() * hyperperiod;
+		std::vector<std::vector<std::size_t>> jobs_of_pe;
+
+		// copy the jobs of one PE into a contiguous workload
+		typename Job<Time>::Job_set workload_of_pe(std::size_t pe) const {
+			typename Job<Time>::Job_set par_jobs;
+			if (pe >= jobs_of_pe.size())
+				return par_jobs;
+			par_jobs.reserve(jobs_of_pe[pe].size());
+			for (auto idx: jobs_of_pe[pe])
+				par_jobs.push_back(jobs[idx]);
+			return par_jobs;
+		}
+	};
+
+	// function to generate job set out of a dag with given hyperperiod
+	// (the hyperperiod must have been calculated beforehand, unless the
+	// observation window is bounded by chains)
+	template<class Time> Generated_jobs<Time> generate_job_set(const typename NP::dag<Time> &dag) {
+		Generated_jobs<Time> gen;
+		typename Job<Time>::Job_set &jobs = gen.jobs;
+		const auto &tasks = dag.get_tasks();
+		auto observation_window = dag.get_observation_window();
+		jobs.reserve(dag.get_number_of_jobs(observation_window));
 		long long id_counter = 0;
 		for (auto &t_instance: tasks) {
 			for (long long i = 0; i < observation_window; i += t_instance->get_period()) {
 				auto tid = t_instance->get_task_id();
 				auto jid = id_counter;
-				auto arr_min = i + t_instance->min_jitter();
-				auto arr_max = i + t_instance->max_jitter();
+				Time arr_min = i + t_instance->min_jitter();
+				Time arr_max = i + t_instance->max_jitter();
 				auto cost_min = t_instance->get_bcet();
 				auto cost_max = t_instance->get_wcet();
-				auto dl = i + t_instance->get_deadline();
+				Time dl = i + t_instance->get_deadline();
 				auto pe = t_instance->get_pe();
 
 				// for EDF priority is deadline
@@ -116,11 +172,20 @@ namespace NP {
 				auto rec_prio = prio;
 				jobs.emplace_back(jid, Interval<Time>{arr_min, arr_max}, Interval<Time>{cost_min, cost_max},
 								  dl, prio, tid, pe);
+				if (pe >= gen.jobs_of_pe.size())
+					gen.jobs_of_pe.resize(pe + 1);
+				gen.jobs_of_pe[pe].push_back(jobs.size() - 1);
 
 				id_counter++;
 			}
 		}
-		return jobs;
+
+		for (auto &bucket: gen.jobs_of_pe)
+			std::stable_sort(bucket.begin(), bucket.end(),
+							 [&jobs](std::size_t a, std::size_t b) {
+								 return jobs[a].earliest_arrival() < jobs[b].earliest_arrival();
+							 });
+		return gen;
 	}
 
 
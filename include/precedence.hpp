@@ -1,8 +1,8 @@
 #ifndef PRECEDENCE_HPP
 #define PRECEDENCE_HPP
 
-#include <queue>
 #include <unordered_map>
+#include <exception>
 
 #include "jobs.hpp"
 #include "index_set.hpp"
@@ -13,126 +13,152 @@ namespace NP {
 	typedef std::vector<Precedence_constraint> Precedence_constraints;
 	typedef std::vector<std::size_t> Job_precedence_set;
 
-	template<class Time>
-	void validate_prec_refs(const Precedence_constraints &dag,
-							const typename Job<Time>::Job_set jobs) {
-		for (auto constraint: dag) {
-			lookup<Time>(jobs, constraint.first);
-			lookup<Time>(jobs, constraint.second);
+	class CyclicPrecedenceConstraints : public std::exception
+	{
+	public:
+
+		virtual const char* what() const noexcept override
+		{
+			return "cyclic precedence constraints";
 		}
+
+	};
+
+	// map each job ID to its position in the job set
+	template<class Time>
+	std::unordered_map<JobID, std::size_t> job_index_map(const typename Job<Time>::Job_set &jobs)
+	{
+		std::unordered_map<JobID, std::size_t> index_map{};
+		index_map.reserve(jobs.size());
+
+		for (std::size_t i = 0; i < jobs.size(); i++)
+			index_map.emplace(jobs[i].get_id(), i);
+
+		return index_map;
 	}
 
 	template<class Time>
-	typename Job<Time>::Job_set topological_sort(const Precedence_constraints &dag,
-												 const typename Job<Time>::Job_set &jobs) {
+	std::vector<Job_precedence_set> job_precedence_sets_of(const Precedence_constraints &dag,
+														   const typename Job<Time>::Job_set &jobs)
+	{
 		std::vector<Job_precedence_set> job_precedence_sets(jobs.size());
+		auto index_map = job_index_map<Time>(jobs);
 
 		for (auto e: dag) {
-			const Job<Time> &from = lookup<Time>(jobs, e.first);
-			const Job<Time> &to = lookup<Time>(jobs, e.second);
-			job_precedence_sets[index_of(to, jobs)].push_back(index_of(from, jobs));
+			auto from = index_map.find(e.first);
+			if (from == index_map.end())
+				throw InvalidJobReference(e.first);
+			auto to = index_map.find(e.second);
+			if (to == index_map.end())
+				throw InvalidJobReference(e.second);
+			job_precedence_sets[to->second].push_back(from->second);
 		}
 
-		return topological_sort<Time>(job_precedence_sets, jobs);
+		return job_precedence_sets;
 	}
 
 	template<class Time>
-	typename Job<Time>::Job_set topological_sort(const std::vector<Job_precedence_set> &job_precedence_sets,
-												 const std::vector<const Job<Time> *> &jobs) {
-		typename Job<Time>::Job_set job_refs{};
+	void validate_prec_refs(const Precedence_constraints &dag,
+							const typename Job<Time>::Job_set &jobs) {
+		job_precedence_sets_of<Time>(dag, jobs);
+	}
 
-		for (auto j: jobs) {
-			job_refs.push_back(*j);
+	// Kahn's algorithm: returns the indices 0..n-1 in a topological order of
+	// the given precedence sets. Predecessor indices outside of [0, n) are
+	// ignored. Jobs without pending predecessors are emitted in index order.
+	inline std::vector<std::size_t> topological_order(const std::vector<Job_precedence_set> &job_precedence_sets,
+													  std::size_t n)
+	{
+		std::vector<std::size_t> in_degree(n, 0);
+		std::vector<std::size_t> succ_offsets(n + 1, 0);
+
+		// build a compact successor list (CSR layout)
+		for (std::size_t i = 0; i < n; i++)
+			for (auto pred: job_precedence_sets[i])
+				if (pred < n) {
+					in_degree[i]++;
+					succ_offsets[pred + 1]++;
+				}
+		for (std::size_t i = 0; i < n; i++)
+			succ_offsets[i + 1] += succ_offsets[i];
+
+		std::vector<std::size_t> successors(succ_offsets[n]);
+		std::vector<std::size_t> fill(succ_offsets.begin(), succ_offsets.end() - 1);
+		for (std::size_t i = 0; i < n; i++)
+			for (auto pred: job_precedence_sets[i])
+				if (pred < n)
+					successors[fill[pred]++] = i;
+
+		std::vector<std::size_t> order;
+		order.reserve(n);
+		for (std::size_t i = 0; i < n; i++)
+			if (in_degree[i] == 0)
+				order.push_back(i);
+
+		// the output vector doubles as the FIFO queue
+		for (std::size_t head = 0; head < order.size(); head++) {
+			auto idx = order[head];
+			for (auto k = succ_offsets[idx]; k < succ_offsets[idx + 1]; k++)
+				if (--in_degree[successors[k]] == 0)
+					order.push_back(successors[k]);
 		}
 
-		return topological_sort<Time>(job_precedence_sets, job_refs);
+		if (order.size() != n)
+			throw CyclicPrecedenceConstraints();
+
+		return order;
 	}
 
 	template<class Time>
-	typename Job<Time>::Job_set topological_sort(const std::vector<Job_precedence_set> &job_precedence_sets,
+	typename Job<Time>::Job_set topological_sort(const Precedence_constraints &dag,
 												 const typename Job<Time>::Job_set &jobs) {
-		std::unordered_map<JobID, std::size_t> job_index_map{};
-
-		for (auto &j: jobs) {
-			job_index_map.emplace(j.get_id(), index_of(j, jobs));
-		}
+		return topological_sort<Time>(job_precedence_sets_of<Time>(dag, jobs), jobs);
+	}
 
-		typename std::vector<std::size_t> sorted_indices{};
-		Index_set processed_indices{};
-		typename Job<Time>::Job_set temp{};
+	template<class Time>
+	typename Job<Time>::Job_set topological_sort(const std::vector<Job_precedence_set> &job_precedence_sets,
+												 const std::vector<const Job<Time> *> &jobs) {
 		typename Job<Time>::Job_set sorted_jobs{};
+		sorted_jobs.reserve(jobs.size());
 
-		for (auto j: jobs) {
-			size_t idx = job_index_map.find(j.get_id())->second;
-			const Job_precedence_set &preds = job_precedence_sets[idx];
-
-			if (preds.empty()) {
-				sorted_indices.push_back(idx);
-				processed_indices.add(idx);
-				sorted_jobs.push_back(j);
-			} else {
-				temp.push_back(j);
-			}
-		}
+		for (auto idx: topological_order(job_precedence_sets, jobs.size()))
+			sorted_jobs.push_back(*jobs[idx]);
 
-		std::deque<Job<Time>> queue(temp.begin(), temp.end());
+		return sorted_jobs;
+	}
 
-		while (not queue.empty()) {
-			Job<Time> &j = queue.front();
-			queue.pop_front();
-			size_t idx = job_index_map.find(j.get_id())->second;
-			const Job_precedence_set &preds = job_precedence_sets[idx];
+	template<class Time>
+	typename Job<Time>::Job_set topological_sort(const std::vector<Job_precedence_set> &job_precedence_sets,
+												 const typename Job<Time>::Job_set &jobs) {
+		typename Job<Time>::Job_set sorted_jobs{};
+		sorted_jobs.reserve(jobs.size());
 
-			// All predecessors of j have been sorted already
-			if (processed_indices.includes(preds)) {
-				sorted_indices.push_back(idx);
-				processed_indices.add(idx);
-				sorted_jobs.push_back(j);
-			} else {
-				queue.push_back(j);
-			}
-		}
+		for (auto idx: topological_order(job_precedence_sets, jobs.size()))
+			sorted_jobs.push_back(jobs[idx]);
 
 		return sorted_jobs;
 	}
 
+	// Raise the arrival bounds of each job to the maximum arrival bounds of
+	// all of its ancestors. Since the bounds of the direct predecessors already
+	// include those of their own ancestors, a single pass in topological
+	// order suffices.
 	template<class Time>
 	typename Job<Time>::Job_set set_arrival_times(const std::vector<Job_precedence_set> &job_precedence_sets,
 												  typename Job<Time>::Job_set jobs) {
-		std::unordered_map<JobID, std::size_t> job_index_map{};
-
-		for (auto &j: jobs) {
-			job_index_map.emplace(j.get_id(), index_of(j, jobs));
-		}
-
-		for (auto &j: jobs) {
-			size_t idx = job_index_map.find(j.get_id())->second;
+		for (auto idx: topological_order(job_precedence_sets, jobs.size())) {
+			Job<Time> &j = jobs[idx];
 			const Job_precedence_set &preds = job_precedence_sets[idx];
 
-			// get all ancestors of j and add them to a vector
-			Job_precedence_set ancestors = preds;
-			std::queue<size_t> q;
-			for (auto pred_idx: preds) {
-				q.push(pred_idx);
-			}
-			while (!q.empty()) {
-				size_t pred_idx = q.front();
-				q.pop();
-				const Job_precedence_set &pred_preds = job_precedence_sets[pred_idx];
-				for (auto pred_pred_idx: pred_preds) {
-					q.push(pred_pred_idx);
-					ancestors.push_back(pred_pred_idx);
-				}
-			}
+			if (preds.empty())
+				continue;
 
 			Time max_earliest_arrival_time = j.earliest_arrival();
 			Time max_latest_arrival_time = j.latest_arrival();
-			if (!ancestors.empty()) {
-				for (auto pred_idx: ancestors) {
-					const Job<Time> &pred = jobs[pred_idx];
-					max_earliest_arrival_time = std::max(max_earliest_arrival_time, pred.earliest_arrival());
-					max_latest_arrival_time = std::max(max_latest_arrival_time, pred.latest_arrival());
-				}
+			for (auto pred_idx: preds) {
+				const Job<Time> &pred = jobs[pred_idx];
+				max_earliest_arrival_time = std::max(max_earliest_arrival_time, pred.earliest_arrival());
+				max_latest_arrival_time = std::max(max_latest_arrival_time, pred.latest_arrival());
 			}
 			j.set_arrival(Interval<Time>(max_earliest_arrival_time, max_latest_arrival_time));
 		}
@@ -148,13 +174,7 @@ namespace NP {
 	template<class Time>
 	typename Job<Time>::Job_set preprocess_jobs(const Precedence_constraints &dag,
 												const typename Job<Time>::Job_set &jobs) {
-		std::vector<Job_precedence_set> job_precedence_sets(jobs.size());
-
-		for (auto e: dag) {
-			const Job<Time> &from = lookup<Time>(jobs, e.first);
-			const Job<Time> &to = lookup<Time>(jobs, e.second);
-			job_precedence_sets[index_of(to, jobs)].push_back(index_of(from, jobs));
-		}
+		auto job_precedence_sets = job_precedence_sets_of<Time>(dag, jobs);
 
 		return topological_sort<Time>(job_precedence_sets, set_arrival_times<Time>(job_precedence_sets, jobs));
 	}
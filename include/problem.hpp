@@ -1,9 +1,13 @@
 #ifndef NP_PROBLEM_HPP
 #define NP_PROBLEM_HPP
 
+#include <string>
+#include <utility>
+
 #include "jobs.hpp"
 #include "precedence.hpp"
 #include "aborts.hpp"
+#include "clock.hpp"
 
 namespace NP {
 
@@ -31,11 +35,11 @@ namespace NP {
 		Scheduling_problem(Workload jobs, Precedence_constraints dag,
 						   unsigned int num_processors = 1)
 				: num_processors(num_processors)
-				, jobs(jobs)
-				, dag(dag)
+				, jobs(std::move(jobs))
+				, dag(std::move(dag))
 		{
 			assert(num_processors > 0);
-			validate_prec_refs<Time>(dag, jobs);
+			validate_prec_refs<Time>(this->dag, this->jobs);
 		}
 
 		// Full constructor with abort actions
@@ -43,19 +47,19 @@ namespace NP {
 						   Abort_actions aborts,
 						   unsigned int num_processors)
 				: num_processors(num_processors)
-				, jobs(jobs)
-				, dag(dag)
-				, aborts(aborts)
+				, jobs(std::move(jobs))
+				, dag(std::move(dag))
+				, aborts(std::move(aborts))
 		{
 			assert(num_processors > 0);
-			validate_prec_refs<Time>(dag, jobs);
-			validate_abort_refs<Time>(aborts, jobs);
+			validate_prec_refs<Time>(this->dag, this->jobs);
+			validate_abort_refs<Time>(this->aborts, this->jobs);
 		}
 
 		// Convenience constructor: no DAG, no abort actions
 		Scheduling_problem(Workload jobs,
 						   unsigned int num_processors = 1)
-				: jobs(jobs)
+				: jobs(std::move(jobs))
 				, num_processors(num_processors)
 		{
 			assert(num_processors > 0);
@@ -68,6 +72,44 @@ namespace NP {
 		// Zero means unlimited.
 		double timeout;
 
+		// Which clock the timeout is measured with (by default, the CPU
+		// time of the thread running the analysis)
+		Clock_source timeout_clock;
+
+		// How many bytes may the states of the exploration occupy before
+		// the analysis degrades and finally gives up? Zero means unlimited.
+		std::size_t memory_limit;
+
+		// Should unexplored states be kept on disk rather than in memory?
+		bool out_of_core;
+
+		// Should states with the same scheduled jobs also be merged if
+		// their finish ranges are adjacent, and states that become
+		// redundant after a merge be dropped?
+		bool subsumption;
+
+		// Approximate merging: also merge states with the same scheduled
+		// jobs whose finish ranges are at most this far apart (in time
+		// units of the workload; zero means only overlapping ranges) ...
+		double merge_tolerance;
+		// ... or if there are this many of them already (zero means no cap)
+		std::size_t merge_cap;
+
+		// Where to write checkpoints of the exploration (empty means
+		// nowhere), and how often (in seconds of wall-clock time, zero
+		// means only when requested; see pending_checkpoint_request())
+		std::string checkpoint_file;
+		double checkpoint_interval;
+
+		// checkpoint to resume from, if it exists
+		std::string resume_file;
+
+		// How often (in seconds of wall-clock time) should the progress of
+		// the exploration be reported to progress()? Zero means never.
+		// Reports carry the given label, e.g., to tell partitions apart.
+		double progress_interval;
+		std::string progress_label;
+
 		// After how many scheduling decisions (i.e., depth of the
 		// schedule graph) should we terminate the analysis?
 		// Zero means unlimited.
@@ -88,6 +130,14 @@ namespace NP {
 
 		Analysis_options()
 				: timeout(0)
+				, timeout_clock(Clock_source::thread_cpu)
+				, memory_limit(0)
+				, out_of_core(false)
+				, subsumption(false)
+				, merge_tolerance(0)
+				, merge_cap(0)
+				, checkpoint_interval(0)
+				, progress_interval(0)
 				, max_depth(0)
 				, early_exit(true)
 				, num_buckets(1000)
@@ -0,0 +1,79 @@
+#ifndef PROGRESS_HPP
+#define PROGRESS_HPP
+
+#include <cstdio>
+#include <string>
+#include <mutex>
+#include <stdexcept>
+#include <iostream>
+#include <fstream>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace NP {
+
+	// Destination of the progress reports of running explorations, one
+	// JSON object per line. Reports of concurrent explorations are written
+	// line by line, so they do not interleave.
+	class Progress_log
+	{
+	public:
+
+		// append to the given file rather than writing to stderr
+		void open(const std::string &file_name)
+		{
+			file.open(file_name, std::ios::out | std::ios::app);
+			if (!file)
+				throw std::runtime_error(file_name + ": cannot write progress reports");
+		}
+
+		void write(const std::string &line)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			std::ostream &out = file.is_open() ? (std::ostream &) file : std::cerr;
+			out << line << std::endl;
+		}
+
+	private:
+		std::ofstream file;
+		std::mutex mutex;
+	};
+
+	// the progress log of this run
+	inline Progress_log& progress()
+	{
+		static Progress_log log;
+		return log;
+	}
+
+	// Bytes currently resident in memory (the peak if the current value is
+	// not available on this platform).
+	inline long resident_set_bytes()
+	{
+#if defined(_WIN32)
+		return 0;
+#else
+		long pages = 0;
+		if (std::FILE *f = std::fopen("/proc/self/statm", "r")) {
+			long size;
+			bool ok = std::fscanf(f, "%ld %ld", &size, &pages) == 2;
+			std::fclose(f);
+			if (ok)
+				return pages * sysconf(_SC_PAGESIZE);
+		}
+		struct rusage u;
+		if (getrusage(RUSAGE_SELF, &u) == 0)
+#ifdef __APPLE__
+			return u.ru_maxrss;
+#else
+			return u.ru_maxrss * 1024;
+#endif
+		return 0;
+#endif
+	}
+}
+
+#endif
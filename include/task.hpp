@@ -52,6 +52,14 @@ namespace NP {
 
 
 		// Encapsulation
+		void set_timing(Time bcet, Time wcet, Time period, Interval<Time> jitter, Time deadline) {
+			this->bcet = bcet;
+			this->wcet = wcet;
+			this->period = period;
+			this->jitter = jitter;
+			this->deadline = deadline;
+		}
+
 		void set_name(std::string name) {
 			this->name = name;
 			this->taskID = std::stol(name.substr(name.find("T") + 1));
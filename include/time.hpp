@@ -3,10 +3,15 @@
 
 #include <utility>
 #include <limits>
+#include <cmath>
+#include <cstdint>
 
 // discrete time
 using dtime_t = long long;
 
+// compact discrete time, for models whose time horizon fits into 32 bits
+using dtime32_t = std::int32_t;
+
 // dense time
 using dense_t = double;
 
@@ -35,6 +40,32 @@ namespace Time_model {
 	};
 
 
+	template<>
+	struct constants<dtime32_t>
+	{
+		static constexpr dtime32_t infinity()
+		{
+			return std::numeric_limits<dtime32_t>::max();
+		}
+
+		static constexpr dtime32_t epsilon()
+		{
+			return 1;
+		}
+
+		static constexpr dtime32_t deadline_miss_tolerance()
+		{
+			return 0;
+		}
+
+		// largest time horizon of a model that can be analysed with this
+		// type: leaves headroom for sums of two bounds below infinity
+		static constexpr dtime_t safe_horizon()
+		{
+			return std::numeric_limits<dtime32_t>::max() / 4;
+		}
+	};
+
 	template<>
 	struct constants<dense_t>
 	{
@@ -57,6 +88,30 @@ namespace Time_model {
 
 	};
 
+	// number of whole quanta in a non-negative time value, rounded down
+	template<typename T>
+	T quanta_below(T t, T quantum)
+	{
+		return t / quantum;
+	}
+
+	// number of quanta needed to cover a non-negative time value
+	template<typename T>
+	T quanta_above(T t, T quantum)
+	{
+		return (t + quantum - 1) / quantum;
+	}
+
+	inline dense_t quanta_below(dense_t t, dense_t quantum)
+	{
+		return std::floor(t / quantum);
+	}
+
+	inline dense_t quanta_above(dense_t t, dense_t quantum)
+	{
+		return std::ceil(t / quantum);
+	}
+
 }
 
 
@@ -0,0 +1,164 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <fstream>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace NP {
+
+	// Timeline of the phases of an analysis run, written in the Chrome
+	// trace-event format (viewable in chrome://tracing or Perfetto).
+	// Nothing is recorded unless open() has been called.
+	class Trace
+	{
+	public:
+
+		bool enabled() const
+		{
+			return on;
+		}
+
+		void open(const std::string &file_name)
+		{
+			file = file_name;
+			origin = Clock::now();
+			on = true;
+		}
+
+		// microseconds since the trace was opened
+		double now() const
+		{
+			return std::chrono::duration<double, std::micro>(Clock::now() - origin).count();
+		}
+
+		// record a span; `args` is empty or the members of a JSON object
+		void complete(const std::string &category, const std::string &name,
+					  double start, double end, const std::string &args = "")
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			events.push_back(Event{category, name, start, end - start, thread_number(), args});
+		}
+
+		// write all recorded spans to the file given to open()
+		bool write() const
+		{
+			std::ofstream out(file, std::ios::out);
+			out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+			bool first = true;
+			for (const auto &e : events) {
+				if (!first)
+					out << ",\n";
+				first = false;
+				out << "{\"ph\": \"X\", \"cat\": \"" << escape(e.category)
+					<< "\", \"name\": \"" << escape(e.name)
+					<< "\", \"ts\": " << std::fixed << e.start
+					<< ", \"dur\": " << e.duration
+					<< ", \"pid\": " << process_id()
+					<< ", \"tid\": " << e.thread;
+				if (!e.args.empty())
+					out << ", \"args\": {" << e.args << "}";
+				out << "}";
+			}
+			out << "\n]}\n";
+			return (bool) out;
+		}
+
+		static std::string escape(const std::string &s)
+		{
+			std::string r;
+			for (char c : s) {
+				if (c == '"' || c == '\\')
+					r += '\\';
+				if ((unsigned char) c >= 0x20)
+					r += c;
+			}
+			return r;
+		}
+
+	private:
+
+		typedef std::chrono::steady_clock Clock;
+
+		struct Event {
+			std::string category, name;
+			double start, duration;
+			unsigned int thread;
+			std::string args;
+		};
+
+		bool on = false;
+		std::string file;
+		Clock::time_point origin;
+
+		std::mutex mutex;
+		std::vector<Event> events;
+		std::unordered_map<std::thread::id, unsigned int> threads;
+
+		// small, stable number of the calling thread (mutex held)
+		unsigned int thread_number()
+		{
+			auto t = threads.find(std::this_thread::get_id());
+			if (t == threads.end())
+				t = threads.emplace(std::this_thread::get_id(), threads.size() + 1).first;
+			return t->second;
+		}
+
+		static long process_id()
+		{
+#ifdef _WIN32
+			return 1;
+#else
+			return (long) getpid();
+#endif
+		}
+	};
+
+	// the trace of this run
+	inline Trace& trace()
+	{
+		static Trace t;
+		return t;
+	}
+
+	// records the span from its construction to its destruction
+	class Trace_span
+	{
+	public:
+
+		Trace_span(const char *category, const std::string &name)
+				: category(category)
+				, name(trace().enabled() ? name : std::string())
+				, start(trace().enabled() ? trace().now() : 0)
+		{
+		}
+
+		// members of a JSON object to attach to the span
+		void set_args(const std::string &a)
+		{
+			args = a;
+		}
+
+		~Trace_span()
+		{
+			if (trace().enabled())
+				trace().complete(category, name, start, trace().now(), args);
+		}
+
+	private:
+		const char *category;
+		std::string name;
+		double start;
+		std::string args;
+	};
+}
+
+#endif
@@ -11,13 +11,15 @@ namespace NP {
 
 			typedef Schedule_state<Time> State;
 			typedef State_space<Time, Null_IIP> Space;
-			typedef typename State_space<Time, Null_IIP>::Workload Jobs;
+			typedef typename Job<Time>::Job_set Jobs;
 
 			typedef Job_set Scheduled;
 
 			static const bool can_block = false;
 
-			Null_IIP(const Space &space, const Jobs &jobs) {}
+			// any engine variant (with or without abort handling)
+			template<class Engine>
+			Null_IIP(const Engine &space, const Jobs &jobs) {}
 
 			Time latest_start(const Job<Time>& j, Time t, const State& s)
 			{
@@ -155,12 +157,12 @@ namespace NP {
 
 				// first, check everything that's already pending at time t
 				// is accounted for
-				for (auto it = space.jobs_by_earliest_arrival
+				for (auto k = space.jobs_by_earliest_arrival
 						.lower_bound(s.earliest_job_release());
-					 it != space.jobs_by_earliest_arrival.end()
-					 && it->second->earliest_arrival() <= at;
-					 it++) {
-					const Job<Time>& j = *(it->second);
+					 k < space.jobs_by_earliest_arrival.size()
+					 && space.jobs_by_earliest_arrival.earliest_arrival(k) <= at;
+					 k++) {
+					const Job<Time>& j = space.jobs_by_earliest_arrival.job(k);
 					auto tid = j.get_task_id();
 					if (j_i.get_task_id() != tid
 						&& space.incomplete(s, j)
@@ -180,11 +182,11 @@ namespace NP {
 				// second, go looking for later releases, if we are still
 				// missing tasks
 
-				for (auto it = space.jobs_by_earliest_arrival.upper_bound(at);
+				for (auto k = space.jobs_by_earliest_arrival.upper_bound(at);
 					 ijs.size() < n_tasks - 1
-					 && it != space.jobs_by_earliest_arrival.end();
-					 it++) {
-					const Job<Time>& j = *it->second;
+					 && k < space.jobs_by_earliest_arrival.size();
+					 k++) {
+					const Job<Time>& j = space.jobs_by_earliest_arrival.job(k);
 					auto tid = j.get_task_id();
 
 					// future jobs should still be pending...
@@ -197,7 +199,7 @@ namespace NP {
 					}
 
 					// can we stop searching already?
-					if (latest_deadline + max_cost < it->first) {
+					if (latest_deadline + max_cost < space.jobs_by_earliest_arrival.earliest_arrival(k)) {
 						// we have reached the horizon --- whatever comes now
 						// cannot influence the latest start time anymore
 						break;
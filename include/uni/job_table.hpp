@@ -0,0 +1,104 @@
+#ifndef JOB_TABLE_HPP
+#define JOB_TABLE_HPP
+
+#include <vector>
+#include <algorithm>
+
+#include "jobs.hpp"
+
+namespace NP {
+
+	namespace Uniproc {
+
+		// The jobs of a workload in order of one of their release bounds.
+		// The fields read by the exploration loops (the release bounds and
+		// the job index) are kept in separate contiguous arrays, so that
+		// scanning for pending jobs does not touch the job records until a
+		// candidate is found.
+		template<class Time> class Job_order_table
+		{
+		public:
+
+			typedef typename Job<Time>::Job_set Workload;
+
+			enum Order { by_earliest_arrival, by_latest_arrival };
+
+			Job_order_table(const Workload &jobs, Order order)
+					: jobs(jobs)
+					, order(order)
+			{
+				std::vector<std::size_t> idx(jobs.size());
+				for (std::size_t i = 0; i < jobs.size(); i++)
+					idx[i] = i;
+				// stable: jobs with the same key stay in workload order
+				std::stable_sort(idx.begin(), idx.end(),
+								 [&jobs, order](std::size_t a, std::size_t b) {
+									 return order == by_earliest_arrival
+											? jobs[a].earliest_arrival() < jobs[b].earliest_arrival()
+											: jobs[a].latest_arrival() < jobs[b].latest_arrival();
+								 });
+
+				index.reserve(jobs.size());
+				earliest.reserve(jobs.size());
+				latest.reserve(jobs.size());
+				for (auto i : idx) {
+					index.push_back(i);
+					earliest.push_back(jobs[i].earliest_arrival());
+					latest.push_back(jobs[i].latest_arrival());
+				}
+			}
+
+			std::size_t size() const
+			{
+				return index.size();
+			}
+
+			// first position whose key is not less than t
+			std::size_t lower_bound(Time t) const
+			{
+				const std::vector<Time> &keys = order == by_earliest_arrival ? earliest : latest;
+				return std::lower_bound(keys.begin(), keys.end(), t) - keys.begin();
+			}
+
+			// first position whose key is greater than t
+			std::size_t upper_bound(Time t) const
+			{
+				const std::vector<Time> &keys = order == by_earliest_arrival ? earliest : latest;
+				return std::upper_bound(keys.begin(), keys.end(), t) - keys.begin();
+			}
+
+			Time earliest_arrival(std::size_t pos) const
+			{
+				return earliest[pos];
+			}
+
+			Time latest_arrival(std::size_t pos) const
+			{
+				return latest[pos];
+			}
+
+			// index of the job in the workload
+			std::size_t job_index(std::size_t pos) const
+			{
+				return index[pos];
+			}
+
+			const Job<Time>& job(std::size_t pos) const
+			{
+				return jobs[index[pos]];
+			}
+
+		private:
+
+			const Workload &jobs;
+			Order order;
+
+			std::vector<std::size_t> index;
+			std::vector<Time> earliest;
+			std::vector<Time> latest;
+		};
+
+	}
+}
+
+#endif
@@ -1,7 +1,9 @@
 #ifndef POR_CRITERION_HPP
 #define POR_CRITERION_HPP
 
+#include "config.h"
 #include "jobs.hpp"
+#include "checkpoint.hpp"
 
 namespace NP {
 
@@ -13,14 +15,23 @@ namespace NP {
 
 			typedef std::vector<const Job<Time>*> Job_set;
 
-			virtual const Job<Time>* select_job(Job_set& jobs) = 0;
+			virtual const Job<Time>* select_job(const Job_set& jobs) = 0;
+
+			// called once per reduction-set construction attempt, with
+			// whether it yielded a reduction set
+			virtual void record_outcome(bool) {}
+
+			// criteria that learn during the exploration keep their state
+			// across a checkpoint
+			virtual void save(Checkpoint_writer &) const {}
+			virtual void restore(Checkpoint_reader &) {}
 		};
 
-		template<class Time> class POR_priority_order: public POR_criterion<Time>
+		template<class Time> class POR_priority_order final: public POR_criterion<Time>
 		{
 		public:
 
-			const Job<Time>* select_job(typename POR_criterion<Time>::Job_set& jobs) override
+			const Job<Time>* select_job(const typename POR_criterion<Time>::Job_set& jobs) override
 			{
 				return *std::min_element(jobs.begin(), jobs.end(),
 										 [](const Job<Time>* i, const Job<Time>* j) -> bool {
@@ -29,11 +40,11 @@ namespace NP {
 			}
 		};
 
-		template<class Time> class POR_release_order: public POR_criterion<Time>
+		template<class Time> class POR_release_order final: public POR_criterion<Time>
 		{
 		public:
 
-			const Job<Time>* select_job(typename POR_criterion<Time>::Job_set& jobs) override
+			const Job<Time>* select_job(const typename POR_criterion<Time>::Job_set& jobs) override
 			{
 				return *std::min_element(jobs.begin(), jobs.end(),
 										 [](const Job<Time>* i, const Job<Time>* j) -> bool {
@@ -42,7 +53,132 @@ namespace NP {
 			}
 		};
 
+		// Add the interfering job with the smallest WCET first (ties broken by
+		// release order), so that the latest busy time of the set grows slowly.
+		template<class Time> class POR_cost_order final: public POR_criterion<Time>
+		{
+		public:
+
+			const Job<Time>* select_job(const typename POR_criterion<Time>::Job_set& jobs) override
+			{
+				return *std::min_element(jobs.begin(), jobs.end(),
+										 [](const Job<Time>* i, const Job<Time>* j) -> bool {
+											 return i->maximal_cost() < j->maximal_cost()
+													|| (i->maximal_cost() == j->maximal_cost()
+														&& i->earliest_arrival() < j->earliest_arrival());
+										 });
+			}
+		};
+
+		// Samples the release-order, priority-order and cost-order criteria in
+		// round-robin fashion during the first reduction attempts that need to
+		// add interfering jobs, then commits to the one with the highest
+		// observed success rate for the rest of the exploration.
+		template<class Time> class POR_adaptive final: public POR_criterion<Time>
+		{
+		public:
+
+			// number of informative attempts per candidate before committing
+			static const unsigned int samples_per_candidate = 16;
+
+			enum Candidate { release_order = 0, priority_order, cost_order, num_candidates };
+
+			POR_adaptive()
+					: current(release_order)
+					, committed(false)
+					, selected(false)
+					, attempts{}
+					, successes{}
+			{
+			}
+
+			const Job<Time>* select_job(const typename POR_criterion<Time>::Job_set& jobs) override
+			{
+				selected = true;
+				switch (current) {
+					case priority_order:
+						return by_priority.select_job(jobs);
+					case cost_order:
+						return by_cost.select_job(jobs);
+					default:
+						return by_release.select_job(jobs);
+				}
+			}
+
+			void record_outcome(bool reduction_success) override
+			{
+				// attempts that never consulted the criterion carry no information
+				if (committed || !selected)
+					return;
+				selected = false;
+
+				attempts[current]++;
+				if (reduction_success)
+					successes[current]++;
+
+				current = static_cast<Candidate>((current + 1) % num_candidates);
+				if (current == release_order && attempts[release_order] == samples_per_candidate)
+					commit();
+			}
+
+			Candidate get_candidate() const
+			{
+				return current;
+			}
+
+			bool has_committed() const
+			{
+				return committed;
+			}
+
+			void save(Checkpoint_writer &out) const override
+			{
+				out.write<std::uint32_t>(current);
+				out.write(committed);
+				out.write(selected);
+				out.write(attempts);
+				out.write(successes);
+			}
+
+			void restore(Checkpoint_reader &in) override
+			{
+				std::uint32_t c;
+				in.read(c);
+				if (c >= num_candidates)
+					in.mismatch("the POR criterion");
+				current = static_cast<Candidate>(c);
+				in.read(committed);
+				in.read(selected);
+				in.read(attempts);
+				in.read(successes);
+			}
+
+		private:
+
+			Candidate current;
+			bool committed;
+			bool selected;
+			unsigned int attempts[num_candidates];
+			unsigned int successes[num_candidates];
+
+			POR_release_order<Time> by_release;
+			POR_priority_order<Time> by_priority;
+			POR_cost_order<Time> by_cost;
+
+			void commit()
+			{
+				// strict comparison: ties favour the earlier (default) candidate
+				Candidate best = release_order;
+				for (int c = release_order + 1; c < num_candidates; c++)
+					if (successes[c] > successes[best])
+						best = static_cast<Candidate>(c);
+				current = best;
+				committed = true;
+				DM("POR adaptive: committed to criterion " << best << std::endl);
+			}
+		};
+
 	}
 }
 
-#endif
\ No newline at end of file
+#endif
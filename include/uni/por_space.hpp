@@ -12,6 +12,7 @@
 #include <ostream>
 #include <cassert>
 #include <queue>
+#include <chrono>
 
 #include "config.h"
 #include "problem.hpp"
@@ -28,16 +29,19 @@ namespace NP {
 
 	namespace Uniproc {
 
-		template<class Time, class IIP = Null_IIP<Time>, class POR_criterion = POR_criterion<Time>>
-		class Por_state_space : public State_space<Time, IIP> {
+		template<class Time, class IIP = Null_IIP<Time>, class POR_criterion = POR_criterion<Time>, bool With_aborts = true>
+		class Por_state_space : public State_space<Time, IIP, With_aborts> {
 
 		public:
 
-			typedef typename State_space<Time, IIP>::Problem Problem;
-			typedef typename State_space<Time, IIP>::Workload Workload;
-			typedef typename State_space<Time, IIP>::Abort_actions Abort_actions;
-			typedef typename State_space<Time, IIP>::State State;
-			typedef typename State_space<Time, IIP>::Job_precedence_set Job_precedence_set;
+			typedef typename State_space<Time, IIP, With_aborts>::Problem Problem;
+			typedef typename State_space<Time, IIP, With_aborts>::Workload Workload;
+			typedef typename State_space<Time, IIP, With_aborts>::Abort_actions Abort_actions;
+			typedef typename State_space<Time, IIP, With_aborts>::State State;
+
+			// the same engine without abort handling
+			typedef Por_state_space<Time, IIP, POR_criterion, false> Abort_free;
+			typedef typename State_space<Time, IIP, With_aborts>::Job_precedence_set Job_precedence_set;
 
 			static Por_state_space explore(
 					const Problem &prob,
@@ -52,12 +56,7 @@ namespace NP {
 				Por_state_space s = Por_state_space(jobs, prob.dag, prob.aborts,
 													opts.timeout, opts.max_depth,
 													opts.num_buckets, opts.early_exit);
-				s.cpu_time.start();
-				if (opts.be_naive)
-					s.explore_naively();
-				else
-					s.explore();
-				s.cpu_time.stop();
+				s.run(opts);
 				return s;
 			}
 
@@ -77,28 +76,43 @@ namespace NP {
 			}
 
 			unsigned long number_of_por_successes() const {
-				return reduction_successes;
+				return reduction_set_statistics.num_successes;
 			}
 
 			unsigned long number_of_por_failures() const {
-				return reduction_failures;
+				return reduction_set_statistics.num_failures;
 			}
 
-			std::vector<Reduction_set_statistics<Time>> get_reduction_set_statistics() const {
+			const Reduction_set_statistics &get_reduction_set_statistics() const {
 				return reduction_set_statistics;
 			}
 
 		protected:
 
-			using State_space<Time, IIP>::explore;
-			using State_space<Time, IIP>::explore_naively;
-			using State_space<Time, IIP>::schedule;
+			using State_space<Time, IIP, With_aborts>::explore;
+			using State_space<Time, IIP, With_aborts>::explore_naively;
+			using State_space<Time, IIP, With_aborts>::schedule;
+
+			typedef std::chrono::high_resolution_clock Stats_clock;
 
 			POR_criterion por_criterion;
-			unsigned long reduction_successes, reduction_failures;
-			std::vector<Reduction_set_statistics<Time>> reduction_set_statistics;
+			Reduction_set_statistics reduction_set_statistics;
 			std::vector<Job_precedence_set> job_precedence_sets;
 
+			std::uint32_t engine_tag() const override {
+				return 1;
+			}
+
+			void save_extra(Checkpoint_writer &out) const override {
+				out.write(reduction_set_statistics);
+				por_criterion.save(out);
+			}
+
+			void restore_extra(Checkpoint_reader &in) override {
+				in.read(reduction_set_statistics);
+				por_criterion.restore(in);
+			}
+
 			Por_state_space(const Workload &jobs,
 							const Precedence_constraints &dag_edges,
 							const Abort_actions &aborts,
@@ -106,15 +120,9 @@ namespace NP {
 							unsigned int max_depth = 0,
 							std::size_t num_buckets = 1000,
 							bool early_exit = true)
-					: State_space<Time, IIP>(jobs, dag_edges, aborts, max_cpu_time, max_depth, num_buckets, early_exit),
-					  por_criterion(), reduction_successes(0), reduction_failures(0), reduction_set_statistics(),
-					  job_precedence_sets(jobs.size()) {
-				for (auto e: dag_edges) {
-					const Job<Time> &from = lookup<Time>(jobs, e.first);
-					const Job<Time> &to = lookup<Time>(jobs, e.second);
-					job_precedence_sets[index_of(to, jobs)].push_back(index_of(from, jobs));
-				}
-
+					: State_space<Time, IIP, With_aborts>(jobs, dag_edges, aborts, max_cpu_time, max_depth, num_buckets, early_exit),
+					  por_criterion(), reduction_set_statistics(),
+					  job_precedence_sets(job_precedence_sets_of<Time>(dag_edges, jobs)) {
 			}
 
 			void schedule_eligible_successors_naively(const State &s, const Interval<Time> &next_range,
@@ -191,46 +199,27 @@ namespace NP {
 
 				auto k = s.next_key(reduction_set);
 
-				auto r = this->states_by_key.equal_range(k);
-
-				if (r.first != r.second) {
-					Job_set sched_jobs{s.get_scheduled_jobs()};
-
-					for (const Job<Time> *j: reduction_set.get_jobs()) {
-						sched_jobs.add(this->index_of(*j));
-					}
-
-					for (auto it = r.first; it != r.second; it++) {
-						State &found = *it->second;
-
-						// key collision if the job sets don't match exactly
-						if (found.get_scheduled_jobs() != sched_jobs)
-							continue;
-
-						// cannot merge without loss of accuracy if the
-						// intervals do not overlap
-						if (!finish_range.intersects(found.finish_range()))
-							continue;
-
-						// great, we found a match and can merge the states
-						found.update_finish_range(finish_range);
-						process_new_edge(s, found, reduction_set, finish_range);
-						return;
-					}
+				// the scheduled set after the transition, computed once for
+				// both the merge check and the next-release query
+				Job_set sched_jobs{s.get_scheduled_jobs()};
+				sched_jobs.add(reduction_set.get_job_mask());
+
+				State *found = this->merge_into_existing_state(k, sched_jobs, finish_range);
+				if (found) {
+					// great, we found a match and merged the states
+					this->num_merges++;
+					process_new_edge(s, *found, reduction_set, finish_range);
+					return;
 				}
 
 				// If we reach here, we didn't find a match and need to create
 				// a new state.
-
-				std::vector<std::size_t> indices{};
-				for (const Job<Time> *j: reduction_set.get_jobs()) {
-					indices.push_back(this->index_of(*j));
-				}
+				Time next_release = earliest_possible_job_release(s, sched_jobs);
 
 				const State &next =
-						this->new_state(s, reduction_set, indices,
+						this->new_state(s, reduction_set, std::move(sched_jobs),
 										finish_range,
-										earliest_possible_job_release(s, reduction_set));
+										next_release);
 				//	DM("      -----> S" << (states.end() - states.begin()) << std::endl);
 				process_new_edge(s, next, reduction_set, finish_range);
 			}
@@ -238,21 +227,23 @@ namespace NP {
 			void schedule_naive(const State &s, const Reduction_set<Time> &reduction_set) {
 				Interval<Time> finish_range = next_finish_times(reduction_set);
 
-				std::vector<std::size_t> indices{};
-				for (const Job<Time> *j: reduction_set.get_jobs()) {
-					indices.push_back(this->index_of(*j));
-				}
+				Job_set sched_jobs{s.get_scheduled_jobs()};
+				sched_jobs.add(reduction_set.get_job_mask());
+				Time next_release = earliest_possible_job_release(s, sched_jobs);
 
 				const State &next =
-						this->new_state(s, reduction_set, indices,
+						this->new_state(s, reduction_set, std::move(sched_jobs),
 										finish_range,
-										earliest_possible_job_release(s, reduction_set));
+										next_release);
 				//	DM("      -----> S" << (states.end() - states.begin()) << std::endl);
 				process_new_edge(s, next, reduction_set, finish_range);
 			}
 
 			Reduction_set<Time>
 			create_reduction_set(const State &s, typename Reduction_set<Time>::Job_set &eligible_successors) {
+				auto t_start = Stats_clock::now();
+				NP_STAT(this->stats.reduction_set_attempts++);
+
 				std::vector<std::size_t> indices{};
 
 				for (const Job<Time> *j: eligible_successors) {
@@ -263,9 +254,9 @@ namespace NP {
 												  eligible_successors, indices, job_precedence_sets};
 
 				while (true) {
+					NP_STAT(this->stats.reduction_set_iterations++);
 					if (reduction_set.has_potential_deadline_misses()) {
-						reduction_failures++;
-						reduction_set_statistics.push_back(Reduction_set_statistics<Time>{false, reduction_set});
+						record_reduction_attempt(false, reduction_set, t_start);
 
 						return reduction_set;
 					}
@@ -283,8 +274,7 @@ namespace NP {
 						}
 
 					if (interfering_jobs.empty()) {
-						reduction_successes++;
-						reduction_set_statistics.push_back(Reduction_set_statistics<Time>{true, reduction_set});
+						record_reduction_attempt(true, reduction_set, t_start);
 
 						return reduction_set;
 					} else {
@@ -296,7 +286,18 @@ namespace NP {
 			}
 
 
-			Time earliest_possible_job_release(const State &s, const Reduction_set<Time> &ignored_set) {
+			void record_reduction_attempt(bool success, const Reduction_set<Time> &reduction_set,
+										  Stats_clock::time_point t_start) {
+				std::chrono::duration<double> elapsed = Stats_clock::now() - t_start;
+				reduction_set_statistics.record(success, reduction_set, elapsed.count());
+				NP_STAT(this->stats.reduction_set_sizes.record(reduction_set.get_jobs().size()));
+				por_criterion.record_outcome(success);
+			}
+
+			// earliest release of a job that is still pending once all jobs
+			// in `next_scheduled` (the state's jobs plus the reduction set)
+			// have completed
+			Time earliest_possible_job_release(const State &s, const Job_set &next_scheduled) {
 				DM("      - looking for earliest possible job release starting from: "
 						   << s.earliest_job_release() << std::endl);
 				const Job<Time> *jp;
@@ -305,16 +306,8 @@ namespace NP {
 
 						DM("         * looking at " << j << std::endl);
 
-						// skip if it is the one we're ignoring
-						bool ignored = false;
-						for (const Job<Time> *ignored_job: ignored_set.get_jobs()) {
-							if (&j == ignored_job) {
-								ignored = true;
-								break;
-							}
-						}
-
-						if (!ignored) {
+						// skip if it is part of the reduction set
+						if (!next_scheduled.contains(this->index_of(j))) {
 							DM("         * found it: " << j.earliest_arrival() << std::endl);
 							// it's incomplete and not ignored => found the earliest
 							return j.earliest_arrival();
@@ -339,27 +332,30 @@ namespace NP {
 					const State &to,
 					const Reduction_set<Time> &reduction_set,
 					const Interval<Time> &finish_range) {
-				// update response times
-				for (const Job<Time> *j: reduction_set.get_jobs()) {
-					this->update_finish_times(*j, Interval<Time>{reduction_set.earliest_finish_time(*j),
-																 reduction_set.latest_finish_time(*j)});
+				// update response times from the per-job bounds cached in the set
+				const auto &jobs = reduction_set.get_jobs();
+				const auto &indices = reduction_set.get_indices();
+				const auto &finish_times = reduction_set.get_finish_times();
+				for (std::size_t i = 0; i < jobs.size(); i++) {
+					this->update_finish_times(indices[i], *jobs[i], finish_times[i]);
 				}
 				// update statistics
 				this->num_edges++;
 #ifdef CONFIG_COLLECT_SCHEDULE_GRAPH
-				this->edges.push_back(std::make_unique<Reduced_edge>(reduction_set, &from, &to, finish_range));
+				if (this->memory_stage == State_space<Time, IIP, With_aborts>::Memory_stage::normal)
+					this->edges.push_back(std::make_unique<Reduced_edge>(reduction_set, &from, &to, finish_range));
 #endif
 			}
 
 
 #ifdef CONFIG_COLLECT_SCHEDULE_GRAPH
 
-			struct Reduced_edge : State_space<Time, IIP>::Edge {
+			struct Reduced_edge : State_space<Time, IIP, With_aborts>::Edge {
 				Reduction_set<Time> reduction_set;
 
 				Reduced_edge(const Reduction_set<Time> &reduction_set, const State *src, const State *tgt,
 							 const Interval<Time> &fr)
-						: State_space<Time, IIP>::Edge(reduction_set.get_jobs()[0], src, tgt, fr),
+						: State_space<Time, IIP, With_aborts>::Edge(reduction_set.get_jobs()[0], src, tgt, fr),
 						  reduction_set{reduction_set} {
 				}
 
@@ -385,7 +381,7 @@ namespace NP {
 
 			};
 
-			void print_edge(std::ostream &out, const std::unique_ptr<typename State_space<Time, IIP>::Edge> &e,
+			void print_edge(std::ostream &out, const std::unique_ptr<typename State_space<Time, IIP, With_aborts>::Edge> &e,
 							unsigned int source_id, unsigned int target_id) const override {
 				out << "\tS" << source_id
 					<< " -> "
@@ -35,6 +35,7 @@ namespace NP {
 			Interval<Time> cpu_availability;
 			Job_set jobs;
 			std::vector<std::size_t> indices;
+			Index_set job_mask;
 			std::vector<Job_precedence_set> job_precedence_sets;
 			std::vector<Job_precedence_set> job_ancestor_sets;
 			Job_set jobs_by_latest_arrival;
@@ -42,7 +43,9 @@ namespace NP {
 			Job_set jobs_by_wcet;
 			Time latest_busy_time;
 			Time latest_idle_time;
-			Job_map latest_start_times;
+			// per-job bounds, aligned with `jobs`
+			std::vector<Time> latest_start_times;
+			std::vector<Interval<Time>> finish_times;
 			hash_value_t key;
 			Priority max_priority_value;
 			unsigned long num_interfering_jobs_added;
@@ -56,6 +59,7 @@ namespace NP {
 					: cpu_availability{cpu_availability},
 					  jobs{jobs},
 					  indices{indices},
+					  job_mask{},
 					  job_precedence_sets{job_precedence_sets},
 					  jobs_by_latest_arrival{jobs},
 					  jobs_by_earliest_arrival{jobs},
@@ -85,11 +89,13 @@ namespace NP {
 
 					index_by_job.emplace(j->get_id(), idx);
 					job_by_index.emplace(std::make_pair(idx, jobs[i]));
+					job_mask.add(idx);
 				}
 
 				latest_busy_time = compute_latest_busy_time();
 				latest_idle_time = compute_latest_idle_time();
 				latest_start_times = compute_latest_start_times();
+				finish_times = compute_finish_times();
 				max_priority_value = compute_max_priority();
 				initialize_key();
 
@@ -99,10 +105,15 @@ namespace NP {
 			Reduction_set(Interval<Time> cpu_availability, const Job_set &jobs, std::vector<std::size_t> indices)
 					: Reduction_set(cpu_availability, jobs, indices, {}) {}
 
-			Job_set get_jobs() const {
+			const Job_set &get_jobs() const {
 				return jobs;
 			}
 
+			// indices of the jobs in the reduction set, as a bitmask
+			const Index_set &get_job_mask() const {
+				return job_mask;
+			}
+
 			Time get_latest_busy_time() const {
 				return latest_busy_time;
 			}
@@ -111,14 +122,24 @@ namespace NP {
 				return latest_idle_time;
 			}
 
+			// global job indices, aligned with get_jobs()
+			const std::vector<std::size_t> &get_indices() const {
+				return indices;
+			}
+
+			// [EFT_i, LFT_i] of each job, aligned with get_jobs()
+			const std::vector<Interval<Time>> &get_finish_times() const {
+				return finish_times;
+			}
+
 			Time get_latest_start_time(const Job<Time> &job) const {
-				auto iterator = latest_start_times.find(job.get_id());
-				return iterator == latest_start_times.end() ? -1 : iterator->second;
+				auto pos = position_of(job);
+				return pos == jobs.size() ? -1 : latest_start_times[pos];
 			}
 
 			bool has_potential_deadline_misses() const {
-				for (const Job<Time> *job: jobs) {
-					if (job->exceeds_deadline(get_latest_start_time(*job) + job->maximal_cost())) {
+				for (std::size_t i = 0; i < jobs.size(); i++) {
+					if (jobs[i]->exceeds_deadline(finish_times[i].until())) {
 						return true;
 					}
 				}
@@ -142,6 +163,7 @@ namespace NP {
 				index_by_job.emplace(jx->get_id(), index);
 				job_by_index.emplace(std::make_pair(index, jobs.back()));
 				indices.push_back(index);
+				job_mask.add(index);
 
 				insert_sorted(jobs_by_latest_arrival, jx,
 							  [](const Job<Time> *i, const Job<Time> *j) -> bool {
@@ -159,6 +181,7 @@ namespace NP {
 				latest_busy_time = compute_latest_busy_time();
 				latest_idle_time = compute_latest_idle_time();
 				latest_start_times = compute_latest_start_times();
+				finish_times = compute_finish_times();
 				key = key ^ jx->get_key();
 
 				if (!jx->priority_at_least(max_priority_value)) {
@@ -213,10 +236,7 @@ namespace NP {
 				}
 
 				Index_set scheduled_union_reduction_set{scheduled_jobs};
-
-				for (auto idx: indices) {
-					scheduled_union_reduction_set.add(idx);
-				}
+				scheduled_union_reduction_set.add(job_mask);
 
 				Index_set predecessor_indices{};
 
@@ -258,8 +278,8 @@ namespace NP {
 				}
 
 				// There exists a J_i s.t. rx_min <= LST^hat_i and p_x < p_i
-				for (const Job<Time> *j: jobs) {
-					if (job.earliest_arrival() <= get_latest_start_time(*j) && job.higher_priority_than(*j)) {
+				for (std::size_t i = 0; i < jobs.size(); i++) {
+					if (job.earliest_arrival() <= latest_start_times[i] && job.higher_priority_than(*jobs[i])) {
 						return true;
 					}
 				}
@@ -280,18 +300,36 @@ namespace NP {
 			}
 
 
-			Job_map compute_latest_start_times() {
+			std::vector<Time> compute_latest_start_times() {
 				// Preprocess priorities p*_i using Eq. 11 in the paper (see [1] at the top of this file)
 				std::unordered_map<JobID, Priority> job_prio_map = preprocess_priorities();
 
-				Job_map start_times{};
+				std::vector<Time> start_times{};
+				start_times.reserve(jobs.size());
 				for (const Job<Time> *j: jobs) {
-					start_times.emplace(j->get_id(), compute_latest_start_time(*j, job_prio_map));
+					start_times.push_back(compute_latest_start_time(*j, job_prio_map));
 				}
 
 				return start_times;
 			}
 
+			std::vector<Interval<Time>> compute_finish_times() const {
+				std::vector<Interval<Time>> bounds{};
+				bounds.reserve(jobs.size());
+				for (std::size_t i = 0; i < jobs.size(); i++) {
+					bounds.emplace_back(earliest_finish_time(*jobs[i]),
+										latest_start_times[i] + jobs[i]->maximal_cost());
+				}
+
+				return bounds;
+			}
+
+			std::size_t position_of(const Job<Time> &job) const {
+				auto pos = std::find_if(jobs.begin(), jobs.end(),
+										[&job](const Job<Time> *j) { return j->get_id() == job.get_id(); });
+				return pos - jobs.begin();
+			}
+
 			// Preprocess priorities for s_i by setting priority of each job to the lowest priority of its predecessors
 			// ---> Eq. 11 in the paper (see [1] at the top of this file) (p*_i)
 			std::unordered_map<JobID, Priority> preprocess_priorities() {
@@ -301,7 +339,7 @@ namespace NP {
 					// the job have precedence constraints
 					// instead of finding all ancestors of each job,
 					// we sort the graph topologically and compute the priorities in the order of the topological sort
-					auto topo_sorted_jobs = topological_sort<Time>(job_precedence_sets, jobs);
+					auto topo_sorted_jobs = topological_sort<Time>(local_precedence_sets(), jobs);
 					for (auto j: topo_sorted_jobs) {
 						const Job_precedence_set &preds = job_precedence_sets[index_by_job.find(j.get_id())->second];
 						// 0 -> highest priority
@@ -384,6 +422,26 @@ namespace NP {
 				return descendants;
 			}
 
+			// Precedence sets of the jobs in J^M, re-indexed by position in `jobs`.
+			// Predecessors outside the reduction set are dropped.
+			std::vector<Job_precedence_set> local_precedence_sets() const {
+				std::unordered_map<std::size_t, std::size_t> position_of{};
+				for (std::size_t i = 0; i < indices.size(); i++) {
+					position_of.emplace(indices[i], i);
+				}
+
+				std::vector<Job_precedence_set> local_sets(jobs.size());
+				for (std::size_t i = 0; i < indices.size(); i++) {
+					for (auto pred_idx: job_precedence_sets[indices[i]]) {
+						auto pos = position_of.find(pred_idx);
+						if (pos != position_of.end()) {
+							local_sets[i].push_back(pos->second);
+						}
+					}
+				}
+				return local_sets;
+			}
+
 			// Upper bound on latest start time (s_i)
 			// ---> Eqs. 12 and 13 in the paper (see [1] at the top of this file)
 			Time compute_si(const Job<Time> &i, const std::unordered_map<JobID, Priority> &job_prio_map) {
@@ -502,25 +560,133 @@ namespace NP {
 			return vec.insert(std::upper_bound(vec.begin(), vec.end(), item, comp), item);
 		}
 
-		template<class Time>
+		// Fixed-size histogram with power-of-two bins: bin 0 counts zeros,
+		// bin k > 0 counts values in [2^(k-1), 2^k), the last bin is open-ended.
+		class Log2_histogram {
+
+		public:
+
+			static const std::size_t num_bins = 24;
+
+			Log2_histogram() : counts{}, total{0}, max_value{0}, num_samples{0} {}
+
+			void record(unsigned long value) {
+				counts[bin_of(value)]++;
+				total += value;
+				max_value = std::max(max_value, value);
+				num_samples++;
+			}
+
+			void merge(const Log2_histogram &other) {
+				for (std::size_t i = 0; i < num_bins; i++) {
+					counts[i] += other.counts[i];
+				}
+				total += other.total;
+				max_value = std::max(max_value, other.max_value);
+				num_samples += other.num_samples;
+			}
+
+			double mean() const {
+				return num_samples ? (double) total / num_samples : 0.0;
+			}
+
+			void write_json(std::ostream &out) const {
+				out << "{\"samples\": " << num_samples
+					<< ", \"mean\": " << mean()
+					<< ", \"max\": " << max_value
+					<< ", \"bins\": [";
+				bool first = true;
+				for (std::size_t i = 0; i < num_bins; i++) {
+					if (!counts[i]) {
+						continue;
+					}
+					if (!first) {
+						out << ", ";
+					}
+					first = false;
+					out << "{\"from\": " << lower_bound(i) << ", \"count\": " << counts[i] << "}";
+				}
+				out << "]}";
+			}
+
+		private:
+
+			unsigned long counts[num_bins];
+			unsigned long long total;
+			unsigned long max_value;
+			unsigned long num_samples;
+
+			static std::size_t bin_of(unsigned long value) {
+				std::size_t bin = 0;
+				while (value && bin < num_bins - 1) {
+					value >>= 1;
+					bin++;
+				}
+				return bin;
+			}
+
+			static unsigned long lower_bound(std::size_t bin) {
+				return bin ? 1UL << (bin - 1) : 0;
+			}
+		};
+
+		// Streaming aggregates over all reduction-set construction attempts.
+		// The memory footprint is constant, no matter how many states are explored.
 		class Reduction_set_statistics {
 
 		public:
 
-			bool reduction_success;
+			unsigned long num_successes, num_failures;
+
+			// size of the final reduction set of each attempt
+			Log2_histogram set_sizes;
+			// number of interfering jobs added to the initial eligible set
+			Log2_histogram interfering_jobs_added;
 
-			unsigned long num_jobs, num_interfering_jobs_added;
+			// time spent constructing reduction sets (in seconds)
+			double total_time, max_time;
 
-			std::vector<Time> priorities;
+			Reduction_set_statistics()
+					: num_successes{0}, num_failures{0}, total_time{0}, max_time{0} {}
 
-			Reduction_set_statistics(bool reduction_success, Reduction_set<Time> &reduction_set)
-					: reduction_success{reduction_success},
-					  num_jobs{reduction_set.get_jobs().size()},
-					  num_interfering_jobs_added{reduction_set.get_num_interfering_jobs_added()},
-					  priorities{} {
-				for (const Job<Time> *j: reduction_set.get_jobs()) {
-					priorities.push_back(j->get_priority());
+			template<class Time>
+			void record(bool reduction_success, const Reduction_set<Time> &reduction_set, double elapsed) {
+				if (reduction_success) {
+					num_successes++;
+				} else {
+					num_failures++;
 				}
+				set_sizes.record(reduction_set.get_jobs().size());
+				interfering_jobs_added.record(reduction_set.get_num_interfering_jobs_added());
+				total_time += elapsed;
+				max_time = std::max(max_time, elapsed);
+			}
+
+			void merge(const Reduction_set_statistics &other) {
+				num_successes += other.num_successes;
+				num_failures += other.num_failures;
+				set_sizes.merge(other.set_sizes);
+				interfering_jobs_added.merge(other.interfering_jobs_added);
+				total_time += other.total_time;
+				max_time = std::max(max_time, other.max_time);
+			}
+
+			unsigned long num_attempts() const {
+				return num_successes + num_failures;
+			}
+
+			void write_json(std::ostream &out) const {
+				out << "{\n"
+					<< "  \"attempts\": " << num_attempts() << ",\n"
+					<< "  \"successes\": " << num_successes << ",\n"
+					<< "  \"failures\": " << num_failures << ",\n"
+					<< "  \"set_sizes\": ";
+				set_sizes.write_json(out);
+				out << ",\n  \"interfering_jobs_added\": ";
+				interfering_jobs_added.write_json(out);
+				out << ",\n  \"total_time\": " << total_time << ",\n"
+					<< "  \"max_time\": " << max_time << "\n"
+					<< "}\n";
 			}
 		};
 	}
@@ -13,14 +13,22 @@
 #include <ostream>
 #include <cassert>
 #include <queue>
+#include <memory>
+#include <sstream>
 
 #include "config.h"
 #include "problem.hpp"
 #include "jobs.hpp"
 #include "precedence.hpp"
 #include "clock.hpp"
+#include "checkpoint.hpp"
+#include "trace.hpp"
+#include "progress.hpp"
 
 #include "uni/state.hpp"
+#include "uni/job_table.hpp"
+#include "uni/spill.hpp"
+#include "uni/statistics.hpp"
 
 namespace NP {
 
@@ -28,7 +36,9 @@ namespace NP {
 
 		template<class Time> class Null_IIP;
 
-		template<class Time, class IIP = Null_IIP<Time>> class State_space
+		// With_aborts = false compiles out the handling of abort actions; the
+		// engine then only accepts problems without abort actions.
+		template<class Time, class IIP = Null_IIP<Time>, bool With_aborts = true> class State_space
 		{
 		public:
 
@@ -37,6 +47,9 @@ namespace NP {
 			typedef typename Scheduling_problem<Time>::Abort_actions Abort_actions;
 			typedef Schedule_state<Time> State;
 
+			// the same engine without abort handling
+			typedef State_space<Time, IIP, false> Abort_free;
+
 			static State_space explore(
 					const Problem& prob,
 					const Analysis_options& opts)
@@ -47,12 +60,7 @@ namespace NP {
 				auto s = State_space(prob.jobs, prob.dag, prob.aborts,
 									 opts.timeout, opts.max_depth,
 									 opts.num_buckets, opts.early_exit);
-				s.cpu_time.start();
-				if (opts.be_naive)
-					s.explore_naively();
-				else
-					s.explore();
-				s.cpu_time.stop();
+				s.run(opts);
 				return s;
 			}
 
@@ -75,20 +83,20 @@ namespace NP {
 
 			Interval<Time> get_finish_times(const Job<Time>& j) const
 			{
-				auto rbounds = rta.find(j.get_id());
-				if (rbounds == rta.end()) {
+				auto idx = job_index_by_id.find(j.get_id());
+				if (idx == job_index_by_id.end() || !has_response_times[idx->second]) {
 					return Interval<Time>{0, Time_model::constants<Time>::infinity()};
 				} else {
-					return rbounds->second;
+					return rta[idx->second];
 				}
 			}
 
 			Interval<Time> get_start_times(const Job<Time>& j) const {
-				auto rbounds = sta.find(j.get_id());
-				if (rbounds == sta.end()) {
+				auto idx = job_index_by_id.find(j.get_id());
+				if (idx == job_index_by_id.end() || !has_response_times[idx->second]) {
 					return Interval<Time>{0, Time_model::constants<Time>::infinity()};
 				} else {
-					return rbounds->second;
+					return sta[idx->second];
 				}
 			}
 
@@ -102,6 +110,37 @@ namespace NP {
 				return timed_out;
 			}
 
+			// the exploration was aborted because the memory limit was reached
+			bool was_memory_exhausted() const
+			{
+				return memory_stage == Memory_stage::exhausted;
+			}
+
+			// the exploration was stopped after taking a checkpoint on request
+			bool was_interrupted() const
+			{
+				return interrupted;
+			}
+
+			// states that were merged or dropped by the dominance check
+			unsigned long number_of_subsumed_states() const
+			{
+				return num_subsumed + (spill ? spill->number_of_subsumed_states() : 0);
+			}
+
+			// merges of states whose finish ranges were apart, which make the
+			// result an over-approximation
+			unsigned long number_of_approximate_merges() const
+			{
+				return num_approximate_merges + (spill ? spill->number_of_approximate_merges() : 0);
+			}
+
+			// largest gap between two merged finish ranges
+			Time get_max_widening() const
+			{
+				return spill ? std::max(max_widening, spill->get_max_widening()) : max_widening;
+			}
+
 			unsigned long number_of_states() const
 			{
 				return num_states;
@@ -117,11 +156,17 @@ namespace NP {
 				return width;
 			}
 
+			// CPU time of the thread that ran the exploration
 			double get_cpu_time() const
 			{
 				return cpu_time;
 			}
 
+			double get_wall_time() const
+			{
+				return wall_time;
+			}
+
 			unsigned long number_of_por_successes() const {
 				return 0;
 			}
@@ -130,6 +175,16 @@ namespace NP {
 				return 0;
 			}
 
+			Reduction_set_statistics get_reduction_set_statistics() const {
+				return Reduction_set_statistics{};
+			}
+
+			// empty unless built with CONFIG_COLLECT_STATISTICS
+			const Exploration_statistics& get_exploration_statistics() const
+			{
+				return stats;
+			}
+
 #ifdef CONFIG_COLLECT_SCHEDULE_GRAPH
 
 			struct Edge {
@@ -192,13 +247,22 @@ namespace NP {
 			typedef std::deque<State*> States;
 			typedef State* State_ref;
 			typedef std::unordered_multimap<hash_value_t, State_ref> States_map;
+			// states with the same key, by earliest finish time
+			typedef std::multimap<Time, State_ref> Finish_index;
 
 			typedef const Job<Time>* Job_ref;
-			typedef std::multimap<Time, Job_ref> By_time_map;
+			typedef Job_order_table<Time> By_time_table;
 
-			typedef std::priority_queue<State_ref, std::deque<State_ref>, bool (*)(State_ref, State_ref)> Todo_queue;
+			// a state waiting to be explored and when it was queued
+			struct Todo_entry {
+				State_ref state;
+				std::uint64_t seq;
+			};
+			typedef std::priority_queue<Todo_entry, std::deque<Todo_entry>,
+										bool (*)(const Todo_entry&, const Todo_entry&)> Todo_queue;
 
-			typedef std::unordered_map<JobID, Interval<Time> > Response_times;
+			// dense tables, indexed by job index
+			typedef std::vector<Interval<Time>> Response_times;
 
 			typedef std::vector<std::size_t> Job_precedence_set;
 
@@ -212,16 +276,48 @@ namespace NP {
 
 			Response_times rta;
 			Response_times sta;
+			std::vector<bool> has_response_times;
+			std::unordered_map<JobID, std::size_t> job_index_by_id;
 			bool aborted;
 			bool timed_out;
 
+			// stages of degradation as the memory limit is approached
+			enum class Memory_stage {
+				normal,
+				compact_bookkeeping,	// >= 3/4: shrink the lookup table, stop collecting edges
+				aggressive_merging,		// >= 9/10: merge states even if finish ranges are disjoint
+				exhausted				// >= limit: abort
+			};
+
+			std::size_t memory_limit = 0;
+			std::size_t state_bytes = 0;
+			Memory_stage memory_stage = Memory_stage::normal;
+
+			// Out-of-core exploration: all states except the initial one
+			// are written to disk when created and read back, merged, in
+			// batches when the in-memory queue runs empty.
+			static const std::size_t default_spill_run_bytes = 64 << 20;
+			static const std::size_t spill_batch = 4096;
+			std::shared_ptr<Spilled_frontier<Time>> spill;
+			// the last spilled state, kept for the caller of new_state()
+			std::shared_ptr<State> last_spilled;
+
+			// checkpoints are taken between two states, when only the
+			// frontier, the bounds found so far and the counters are needed
+			// to continue
+			enum { checkpoint_version = 5 };
+			std::string checkpoint_file;
+			double checkpoint_interval = 0;
+			double last_checkpoint = 0;
+			bool interrupted = false;
+			bool resumed = false;
+
 			const Workload& jobs;
 
 			std::vector<Job_precedence_set> job_precedence_sets;
 
-			By_time_map jobs_by_latest_arrival;
-			By_time_map jobs_by_earliest_arrival;
-			By_time_map jobs_by_deadline;
+			By_time_table jobs_by_latest_arrival;
+			By_time_table jobs_by_earliest_arrival;
 
 			std::vector<const Abort_action<Time>*> abort_actions;
 
@@ -229,14 +325,62 @@ namespace NP {
 			unsigned long num_states, num_edges, width;
 			States_map states_by_key;
 
-			bool (* todo_queue_cmp)(State_ref, State_ref) = [](State_ref left, State_ref right) {
-				return left->get_scheduled_jobs().size() > right->get_scheduled_jobs().size();
+			Exploration_statistics stats;
+
+			// the exploration shows up in the trace as one span per block of
+			// this many layers (depths)
+			static const std::size_t layers_per_trace_span = 64;
+			std::size_t trace_first_layer = 0;
+			unsigned long trace_first_state = 0;
+			double trace_block_start = 0;
+
+			// progress reports are due every `progress_interval` seconds of
+			// wall-clock time; the clock is only read every `progress_stride`
+			// states
+			static const unsigned int progress_stride = 64;
+			double progress_interval = 0;
+			std::string progress_label;
+			unsigned int progress_countdown = progress_stride;
+			double progress_start = 0, last_progress = 0;
+			std::size_t progress_first_layer = 0;
+			unsigned long progress_states = 0, progress_merges = 0;
+			// transitions merged into an existing state (in memory)
+			unsigned long num_merges = 0;
+
+			// with the dominance check, states are looked up by key and finish
+			// time instead; the states of each job set are kept disjoint and
+			// not adjacent
+			bool subsumption = false;
+			std::unordered_map<hash_value_t, Finish_index> states_by_finish;
+			// dropped states that are still in the todo queue
+			std::unordered_set<State_ref> subsumed;
+			unsigned long num_subsumed = 0;
+
+			// approximate merging: states with the same job set are also
+			// merged if their finish ranges are at most `merge_tolerance`
+			// apart, or if there are `merge_cap` of them already
+			bool approximate = false;
+			Time merge_tolerance = 0;
+			std::size_t merge_cap = 0;
+			unsigned long num_approximate_merges = 0;
+			Time max_widening = 0;
+
+			// shallowest states first; states of the same depth in the order in
+			// which they were queued, so that a resumed exploration proceeds
+			// exactly like an uninterrupted one
+			bool (* todo_queue_cmp)(const Todo_entry&, const Todo_entry&) = [](const Todo_entry& left, const Todo_entry& right) {
+				auto l = left.state->get_scheduled_jobs().size(), r = right.state->get_scheduled_jobs().size();
+				return l > r || (l == r && left.seq > right.seq);
 			};
 
 			Todo_queue todo;
+			std::uint64_t next_todo_seq = 0;
 			unsigned long current_job_count;
 
-			Processor_clock cpu_time;
+			Processor_clock cpu_time{Clock_source::thread_cpu};
+			Processor_clock process_time{Clock_source::process_cpu};
+			Processor_clock wall_time{Clock_source::wall};
+			Clock_source timeout_clock = Clock_source::thread_cpu;
 			double timeout;
 
 			unsigned int max_depth;
@@ -251,7 +395,11 @@ namespace NP {
 						unsigned int max_depth = 0,
 						std::size_t num_buckets = 1000,
 						bool early_exit = true)
-					: jobs(jobs)
+					: rta(jobs.size())
+					, sta(jobs.size())
+					, has_response_times(jobs.size(), false)
+					, job_index_by_id(job_index_map<Time>(jobs))
+					, jobs(jobs)
 					, aborted(false)
 					, timed_out(false)
 					, timeout(max_cpu_time)
@@ -262,21 +410,15 @@ namespace NP {
 					, width(0)
 					, todo(todo_queue_cmp)
 					, current_job_count(0)
-					, job_precedence_sets(jobs.size())
+					, job_precedence_sets(job_precedence_sets_of<Time>(dag_edges, jobs))
 					, early_exit(early_exit)
 					, observed_deadline_miss(false)
-					, abort_actions(jobs.size(), NULL)
+					, jobs_by_latest_arrival(jobs, By_time_table::by_latest_arrival)
+					, jobs_by_earliest_arrival(jobs, By_time_table::by_earliest_arrival)
+					, abort_actions(With_aborts ? jobs.size() : 0, NULL)
 			{
-				for (const Job<Time>& j : jobs) {
-					jobs_by_latest_arrival.insert({j.latest_arrival(), &j});
-					jobs_by_earliest_arrival.insert({j.earliest_arrival(), &j});
-					jobs_by_deadline.insert({j.get_deadline(), &j});
-				}
-				for (auto e : dag_edges) {
-					const Job<Time>& from = lookup<Time>(jobs, e.first);
-					const Job<Time>& to   = lookup<Time>(jobs, e.second);
-					job_precedence_sets[index_of(to)].push_back(index_of(from));
-				}
+				if (!With_aborts && !aborts.empty())
+					throw std::invalid_argument("abort actions given to an abort-free engine");
 				for (const Abort_action<Time>& a : aborts) {
 					const Job<Time>& j = lookup<Time>(jobs, a.get_id());
 					abort_actions[index_of(j)] = &a;
@@ -295,26 +437,28 @@ namespace NP {
 
 			void update_finish_times(const Job<Time>& j, Interval<Time> range)
 			{
-				auto rbounds = rta.find(j.get_id());
+				update_finish_times(index_of(j), j, range);
+			}
+
+			void update_finish_times(std::size_t idx, const Job<Time>& j, Interval<Time> range)
+			{
 				auto start_time = range - j.get_cost();
-				if (rbounds == rta.end()) {
-					rta.emplace(j.get_id(), range);
-					sta.emplace(j.get_id(), start_time);
-					if (j.exceeds_deadline(range.upto()))
-						observed_deadline_miss = true;
+				if (!has_response_times[idx]) {
+					rta[idx] = range;
+					sta[idx] = start_time;
+					has_response_times[idx] = true;
 				} else {
-					rbounds->second.widen(range);
-					auto sbounds = sta.find(j.get_id());
-					sbounds->second.widen(start_time);
-
-					if (j.exceeds_deadline(rbounds->second.upto()))
-						observed_deadline_miss = true;
+					rta[idx].widen(range);
+					sta[idx].widen(start_time);
 				}
+				if (j.exceeds_deadline(rta[idx].upto()))
+					observed_deadline_miss = true;
+
 				DM("      New start time range for " << j
-													 << ": " << sta.find(j)->second << std::endl);
+													 << ": " << sta[idx] << std::endl);
 
 				DM("      New finish time range for " << j
-													  << ": " << rta.find(j.get_id())->second << std::endl);
+													  << ": " << rta[idx] << std::endl);
 
 
 				if (early_exit && observed_deadline_miss)
@@ -341,15 +485,15 @@ namespace NP {
 			{
 				const Scheduled &already_scheduled = s.get_scheduled_jobs();
 
-				for (auto it = jobs_by_latest_arrival
+				for (auto k = jobs_by_latest_arrival
 						.lower_bound(s.earliest_finish_time());
-					 it != jobs_by_latest_arrival.end(); it++) {
-					const Job<Time>& j = *(it->second);
+					 k < jobs_by_latest_arrival.size(); k++) {
+					const Job<Time>& j = jobs_by_latest_arrival.job(k);
 
 					DM(__FUNCTION__ << " considering:: "  << j << std::endl);
 
 					// not relevant if already scheduled
-					if (!incomplete(already_scheduled, j))
+					if (already_scheduled.contains(jobs_by_latest_arrival.job_index(k)))
 						continue;
 
 					// If the job is not IIP-eligible when it is certainly
@@ -361,9 +505,10 @@ namespace NP {
 					// It must be priority-eligible when released, too.
 					// Relevant only if we have an IIP, otherwise the job is
 					// trivially priority-eligible.
-					if (iip.can_block &&
-						!priority_eligible(s, j, std::max(j.latest_arrival(), s.latest_finish_time())))
-						continue;
+					NP_IF_CONSTEXPR (IIP::can_block) {
+						if (!priority_eligible(s, j, std::max(j.latest_arrival(), s.latest_finish_time())))
+							continue;
+					}
 
 					// great, this job fits the bill
 					return j.latest_arrival();
@@ -379,15 +524,15 @@ namespace NP {
 					const Job<Time>& reference_job)
 			{
 
-				for (auto it = jobs_by_latest_arrival
+				for (auto k = jobs_by_latest_arrival
 						.lower_bound(s.earliest_finish_time());
-					 it != jobs_by_latest_arrival.end(); it++) {
-					const Job<Time>& j = *(it->second);
-
+					 k < jobs_by_latest_arrival.size(); k++) {
 					// not relevant if already scheduled
-					if (!incomplete(s, j))
+					if (s.get_scheduled_jobs().contains(jobs_by_latest_arrival.job_index(k)))
 						continue;
 
+					const Job<Time>& j = jobs_by_latest_arrival.job(k);
+
 					// irrelevant if not of sufficient priority
 					if (!j.higher_priority_than(reference_job))
 						continue;
@@ -404,27 +549,28 @@ namespace NP {
 // Iterate over all incomplete jobs in state ppj_macro_local_s.
 // ppj_macro_local_j is of type const Job<Time>*
 #define foreach_possibly_pending_job(ppj_macro_local_s, ppj_macro_local_j) 	\
-	for (auto ppj_macro_local_it = this->jobs_by_earliest_arrival			\
+	for (auto ppj_macro_local_k = this->jobs_by_earliest_arrival			\
                      .lower_bound((ppj_macro_local_s).earliest_job_release()); \
-	     ppj_macro_local_it != this->jobs_by_earliest_arrival.end() 				\
-	        && (ppj_macro_local_j = ppj_macro_local_it->second); 	\
-	     ppj_macro_local_it++) \
-		if (this->incomplete(ppj_macro_local_s, *ppj_macro_local_j))
+	     ppj_macro_local_k < this->jobs_by_earliest_arrival.size() 				\
+	        && (ppj_macro_local_j = &this->jobs_by_earliest_arrival.job(ppj_macro_local_k)); 	\
+	     ppj_macro_local_k++ NP_STAT(, this->stats.job_iterations++)) \
+		if (!(ppj_macro_local_s).get_scheduled_jobs().contains(this->jobs_by_earliest_arrival.job_index(ppj_macro_local_k)))
 
 // Iterate over all incomplete jobs that are released no later than ppju_macro_local_until
 #define foreach_possbly_pending_job_until(ppju_macro_local_s, ppju_macro_local_j, ppju_macro_local_until) 	\
-	for (auto ppju_macro_local_it = this->jobs_by_earliest_arrival			\
+	for (auto ppju_macro_local_k = this->jobs_by_earliest_arrival			\
                      .lower_bound((ppju_macro_local_s).earliest_job_release()); \
-	     ppju_macro_local_it != this->jobs_by_earliest_arrival.end() 				\
-	        && (ppju_macro_local_j = ppju_macro_local_it->second, ppju_macro_local_j->earliest_arrival() <= (ppju_macro_local_until)); 	\
-	     ppju_macro_local_it++) \
-		if (this->incomplete(ppju_macro_local_s, *ppju_macro_local_j))
+	     ppju_macro_local_k < this->jobs_by_earliest_arrival.size() 				\
+	        && this->jobs_by_earliest_arrival.earliest_arrival(ppju_macro_local_k) <= (ppju_macro_local_until) 	\
+	        && (ppju_macro_local_j = &this->jobs_by_earliest_arrival.job(ppju_macro_local_k)); 	\
+	     ppju_macro_local_k++ NP_STAT(, this->stats.job_iterations++)) \
+		if (!(ppju_macro_local_s).get_scheduled_jobs().contains(this->jobs_by_earliest_arrival.job_index(ppju_macro_local_k)))
 
 // Iterare over all incomplete jobs that are certainly released no later than
 // cpju_macro_local_until
 #define foreach_certainly_pending_job_until(cpju_macro_local_s, cpju_macro_local_j, cpju_macro_local_until) \
 	foreach_possbly_pending_job_until(cpju_macro_local_s, cpju_macro_local_j, (cpju_macro_local_until)) \
-		if (cpju_macro_local_j->latest_arrival() <= (cpju_macro_local_until))
+		if (this->jobs_by_earliest_arrival.latest_arrival(ppju_macro_local_k) <= (cpju_macro_local_until))
 
 			// returns true if there is certainly some pending job of higher
 			// priority at the given time ready to be scheduled
@@ -491,7 +637,10 @@ namespace NP {
 
 			bool iip_eligible(const State &s, const Job<Time> &j, Time t)
 			{
-				return !iip.can_block || t <= iip.latest_start(j, t, s);
+				NP_IF_CONSTEXPR (!IIP::can_block)
+					return true;
+				else
+					return t <= iip.latest_start(j, t, s);
 			}
 
 			bool priority_eligible(const State &s, const Job<Time> &j, Time t)
@@ -507,7 +656,7 @@ namespace NP {
 				const Job<Time>* jp;
 				foreach_certainly_pending_job_until(s, jp, ts_min) {
 							const Job<Time>& j = *jp;
-							if ((!iip.can_block || priority_eligible(s, j, ts_min))
+							if ((!IIP::can_block || priority_eligible(s, j, ts_min))
 								&& iip_eligible(s, j, ts_min)) {
 								DM("\t\t\t\tcertainly released by "
 										   << ts_min << ":" << j << std::endl);
@@ -546,32 +695,87 @@ namespace NP {
 
 			bool is_eligible_successor(const State &s, const Job<Time> &j)
 			{
+				NP_STAT(stats.eligibility_checks++);
 				if (!incomplete(s, j)) {
 					DM("  --> already complete"  << std::endl);
+					NP_STAT(stats.rejected_complete++);
 					return false;
 				}
 				if (!ready(s, j)) {
 					DM("  --> not ready"  << std::endl);
+					NP_STAT(stats.rejected_not_ready++);
 					return false;
 				}
 				auto t_s = next_earliest_start_time(s, j);
 				if (!priority_eligible(s, j, t_s)) {
 					DM("  --> not prio eligible"  << std::endl);
+					NP_STAT(stats.rejected_priority++);
 					return false;
 				}
 				if (!potentially_next(s, j)) {
 					DM("  --> not potentially next" <<  std::endl);
+					NP_STAT(stats.rejected_not_next++);
 					return false;
 				}
 				if (!iip_eligible(s, j, t_s)) {
 					DM("  --> not IIP eligible" << std::endl);
+					NP_STAT(stats.rejected_iip++);
 					return false;
 				}
+				NP_STAT(stats.eligible++);
 				return true;
 			}
 
+			// explore according to the run-time options
+			void run(const Analysis_options& opts)
+			{
+				configure(opts);
+				start_clocks();
+				if (!opts.resume_file.empty())
+					resume_from(opts.resume_file);
+				trace_block_start = trace().now();
+				start_progress();
+				if (opts.be_naive)
+					explore_naively();
+				else
+					explore();
+				if (trace().enabled())
+					trace_layers(true);
+				if (progress_interval)
+					report_progress(true);
+				stop_clocks();
+				// a final snapshot lets a resumed run skip this exploration
+				if (!checkpoint_file.empty() && !interrupted)
+					save_checkpoint();
+			}
+
+			// options that do not affect how the engine is constructed
+			void configure(const Analysis_options& opts)
+			{
+				timeout_clock = opts.timeout_clock;
+				memory_limit = opts.memory_limit;
+				checkpoint_file = opts.checkpoint_file;
+				checkpoint_interval = opts.checkpoint_interval;
+				progress_interval = opts.progress_interval;
+				progress_label = opts.progress_label;
+#ifndef CONFIG_COLLECT_SCHEDULE_GRAPH
+				subsumption = opts.subsumption;
+				approximate = opts.merge_tolerance > 0 || opts.merge_cap > 0;
+				merge_tolerance = (Time) opts.merge_tolerance;
+				merge_cap = opts.merge_cap;
+				if (opts.out_of_core)
+					spill.reset(new Spilled_frontier<Time>(
+							opts.memory_limit ? opts.memory_limit / 4 : default_spill_run_bytes,
+							subsumption ? Time_model::constants<Time>::epsilon() : Time(0),
+							merge_tolerance));
+#endif
+			}
+
 			void make_initial_state()
 			{
+				// a resumed exploration continues from the restored frontier
+				if (resumed)
+					return;
 				// construct initial state
 				new_state();
 			}
@@ -581,74 +785,673 @@ namespace NP {
 			{
 				State_ref s_ref = new State(std::forward<Args>(args)...);
 
+				if (spill && num_states) {
+					// counted once merged, when read back
+					spill->push(s_ref->get_key(), s_ref->finish_range(),
+								s_ref->earliest_job_release(), s_ref->get_scheduled_jobs());
+					last_spilled.reset(s_ref);
+					width = std::max(width, (unsigned long) (todo.size() + spill->size()) - 1);
+					return *s_ref;
+				} else if (spill) {
+					// the initial state is explored directly
+					push_todo(s_ref);
+					state_bytes += footprint(*s_ref);
+					num_states++;
+					return *s_ref;
+				}
+
 #ifdef CONFIG_COLLECT_SCHEDULE_GRAPH
 				states.push_back(s_ref);
 #endif
-				todo.push(s_ref);
-				states_by_key.insert(std::make_pair(s_ref->get_key(), s_ref));
+				push_todo(s_ref);
+				index_state(s_ref);
+				state_bytes += footprint(*s_ref);
 				num_states++;
 				width = std::max(width, (unsigned long) todo.size() - 1);
 				return *s_ref;
 			}
 
+			void push_todo(State_ref s)
+			{
+				todo.push(Todo_entry{s, next_todo_seq++});
+			}
+
+			void index_state(State_ref s)
+			{
+				if (subsumption)
+					states_by_finish[s->get_key()].insert(std::make_pair(s->earliest_finish_time(), s));
+				else
+					states_by_key.insert(std::make_pair(s->get_key(), s));
+			}
+
+			void unindex_state(State_ref s)
+			{
+				bool deleted = false;
+				if (subsumption) {
+					auto idx = states_by_finish.find(s->get_key());
+					if (idx != states_by_finish.end()) {
+						auto matches = idx->second.equal_range(s->earliest_finish_time());
+						for (auto it = matches.first; it != matches.second; it++)
+							if (it->second == s) {
+								idx->second.erase(it);
+								deleted = true;
+								break;
+							}
+						if (idx->second.empty())
+							states_by_finish.erase(idx);
+					}
+				} else {
+					auto matches = states_by_key.equal_range(s->get_key());
+					for (auto it = matches.first; it != matches.second; it++)
+						if (it->second == s) {
+							states_by_key.erase(it);
+							deleted = true;
+							break;
+						}
+				}
+				assert(deleted);
+			}
+
+			// Dominance check: find a state with the same scheduled jobs
+			// whose finish range overlaps or is adjacent to the given range,
+			// widen it to cover the range, and absorb the other states that it
+			// now overlaps or touches. Returns NULL if there is no such state.
+			// (States with the same scheduled jobs have the same earliest
+			// pending release; it is compared anyway before two existing
+			// states are combined.)
+			State* subsume(hash_value_t key, const Job_set &sched_jobs, const Interval<Time> &finish_range)
+			{
+				auto idx = states_by_finish.find(key);
+				if (idx == states_by_finish.end())
+					return NULL;
+				Finish_index &by_finish = idx->second;
+				const Time eps = Time_model::constants<Time>::epsilon();
+
+				// the states that touch the range are the last ones that
+				// start no later than just after it
+				auto it = finish_range.until() < Time_model::constants<Time>::infinity() - eps
+						  ? by_finish.upper_bound(finish_range.until() + eps)
+						  : by_finish.end();
+				auto target = by_finish.end();
+				std::vector<typename Finish_index::iterator> absorbed;
+				bool overlaps = false;
+				while (it != by_finish.begin()) {
+					--it;
+					State_ref c = it->second;
+					// key collision if the job sets don't match exactly
+					if (c->get_scheduled_jobs() != sched_jobs) {
+						NP_STAT(stats.key_collisions++);
+						continue;
+					}
+					if (c->latest_finish_time() < finish_range.from() - eps)
+						break;
+					if (target == by_finish.end())
+						target = it;
+					else if (c->earliest_job_release() == target->second->earliest_job_release())
+						absorbed.push_back(it);
+					else
+						continue;
+					overlaps = overlaps || c->finish_range().intersects(finish_range);
+				}
+
+				if (target == by_finish.end()) {
+					if (!approximate && memory_stage < Memory_stage::aggressive_merging)
+						return NULL;
+					// nothing touches the range: maybe merge with the closest
+					// state with the same jobs anyway
+					Time closest_gap = 0;
+					std::size_t same_jobs = 0;
+					for (it = by_finish.begin(); it != by_finish.end(); it++) {
+						if (it->second->get_scheduled_jobs() != sched_jobs)
+							continue;
+						same_jobs++;
+						Time g = gap(it->second->finish_range(), finish_range);
+						if (target == by_finish.end() || g < closest_gap) {
+							target = it;
+							closest_gap = g;
+						}
+					}
+					if (target == by_finish.end() || !may_merge_apart(closest_gap, same_jobs))
+						return NULL;
+					record_widening(closest_gap);
+					overlaps = true;
+				}
+
+				State_ref s = target->second;
+				// merging only overlapping ranges would have needed a new state
+				if (!overlaps)
+					num_subsumed++;
+				for (auto a : absorbed) {
+					s->widen_finish_range(a->second->finish_range());
+					subsumed.insert(a->second);
+					by_finish.erase(a);
+					num_subsumed++;
+				}
+				s->widen_finish_range(finish_range);
+				// re-index under the new earliest finish time
+				by_finish.erase(target);
+				by_finish.insert(std::make_pair(s->earliest_finish_time(), s));
+				return s;
+			}
+
 			bool not_done()
 			{
-				return !todo.empty();
+				drop_subsumed_states();
+				return !todo.empty() || (spill && load_spilled_states());
+			}
+
+			// states absorbed by others are skipped when their turn comes
+			void drop_subsumed_states()
+			{
+				while (!subsumed.empty() && !todo.empty() && subsumed.count(todo.top().state)) {
+					State_ref s = todo.top().state;
+					todo.pop();
+					subsumed.erase(s);
+#ifndef CONFIG_COLLECT_SCHEDULE_GRAPH
+					state_bytes -= footprint(*s);
+					delete s;
+#endif
+				}
+			}
+
+			// move the next batch of merged states of the shallowest layer on
+			// disk into memory
+			bool load_spilled_states()
+			{
+				typename Spilled_frontier<Time>::Record r;
+				// only start on the next layer once the current one is done
+				if (!spill->next(r) && !(spill->open_next_layer() && spill->next(r)))
+					return false;
+				std::size_t n = 0;
+				do {
+					State_ref s_ref = new State(Job_set{std::move(r.words)},
+												Interval<Time>{r.finish_from, r.finish_until},
+												r.earliest_release, r.key);
+					push_todo(s_ref);
+					state_bytes += footprint(*s_ref);
+					num_states++;
+				} while (++n < spill_batch && spill->next(r));
+				return true;
 			}
 
 			const State& next_state()
 			{
-				return *todo.top();
+				return *todo.top().state;
 			}
 
 			bool in_todo(State_ref s)
 			{
 				for (auto it : todo)
-					if (it == s)
+					if (it.state == s)
 						return true;
 				return false;
 			}
 
+			void start_clocks()
+			{
+				cpu_time.start();
+				process_time.start();
+				wall_time.start();
+			}
+
+			void stop_clocks()
+			{
+				cpu_time.stop();
+				process_time.stop();
+				wall_time.stop();
+			}
+
+			// time spent so far, as measured by the clock selected for the timeout
+			double time_budget_used() const
+			{
+				switch (timeout_clock) {
+					case Clock_source::process_cpu:
+						return process_time;
+					case Clock_source::wall:
+						return wall_time;
+					default:
+						return cpu_time;
+				}
+			}
+
+			// bytes held by a state and its lookup-table entry
+			static std::size_t footprint(const State &s)
+			{
+				return sizeof(State) + s.get_scheduled_jobs().heap_bytes()
+					   + sizeof(typename States_map::value_type) + 2 * sizeof(void*);
+			}
+
+			std::size_t memory_in_use() const
+			{
+				return state_bytes
+					   + states_by_key.bucket_count() * sizeof(void*)
+					   + todo.size() * sizeof(Todo_entry);
+			}
+
+			void check_memory_budget()
+			{
+				if (!memory_limit)
+					return;
+
+				auto used = memory_in_use();
+				if (used >= memory_limit) {
+					memory_stage = Memory_stage::exhausted;
+					aborted = true;
+				} else if (used >= memory_limit / 10 * 9) {
+					memory_stage = std::max(memory_stage, Memory_stage::aggressive_merging);
+				} else if (used >= memory_limit / 4 * 3) {
+					memory_stage = std::max(memory_stage, Memory_stage::compact_bookkeeping);
+				}
+
+				// the bucket array never shrinks by itself
+				if (memory_stage >= Memory_stage::compact_bookkeeping
+					&& states_by_key.bucket_count() > 4 * states_by_key.size())
+					states_by_key.rehash(0);
+			}
+
+			// Merge the finish range of a new transition into an existing state
+			// with the given scheduled jobs, if possible. Returns NULL if a new
+			// state is needed.
+			State* merge_into_existing_state(hash_value_t k, const Job_set &sched_jobs,
+											 const Interval<Time> &finish_range)
+			{
+				NP_STAT(Phase_timer timer(stats.merge_time));
+				NP_STAT(stats.merge_attempts++);
+
+				if (subsumption) {
+					State *found = subsume(k, sched_jobs, finish_range);
+					NP_STAT(stats.merges += found != NULL);
+					return found;
+				}
+
+				auto r = states_by_key.equal_range(k);
+				State_ref closest = NULL;
+				Time closest_gap = 0;
+				std::size_t same_jobs = 0;
+				for (auto it = r.first; it != r.second; it++) {
+					State &found = *it->second;
+
+					// key collision if the job sets don't match exactly
+					if (found.get_scheduled_jobs() != sched_jobs) {
+						NP_STAT(stats.key_collisions++);
+						continue;
+					}
+
+					if (finish_range.intersects(found.finish_range())) {
+						found.update_finish_range(finish_range);
+						NP_STAT(stats.merges++);
+						return &found;
+					}
+
+					same_jobs++;
+					Time g = gap(found.finish_range(), finish_range);
+					if (!closest || g < closest_gap) {
+						closest = it->second;
+						closest_gap = g;
+					}
+				}
+
+				// cannot merge disjoint ranges without loss of accuracy,
+				// unless allowed to
+				if (!closest || !may_merge_apart(closest_gap, same_jobs))
+					return NULL;
+				record_widening(closest_gap);
+				closest->widen_finish_range(finish_range);
+				NP_STAT(stats.merges++);
+				return closest;
+			}
+
+			// distance between two disjoint intervals
+			static Time gap(const Interval<Time> &a, const Interval<Time> &b)
+			{
+				return a.until() < b.from() ? b.from() - a.until() : a.from() - b.until();
+			}
+
+			// may a transition be merged into a state with the same jobs whose
+			// finish range is `gap` apart, given that there are `same_jobs`
+			// such states?
+			bool may_merge_apart(Time gap, std::size_t same_jobs) const
+			{
+				// short of memory
+				if (memory_stage >= Memory_stage::aggressive_merging)
+					return true;
+				return approximate
+					   && (gap <= merge_tolerance || (merge_cap && same_jobs >= merge_cap));
+			}
+
+			void record_widening(Time gap)
+			{
+				num_approximate_merges++;
+				max_widening = std::max(max_widening, gap);
+			}
+
 			void check_cpu_timeout()
 			{
-				if (timeout && get_cpu_time() > timeout) {
+				if (timeout && time_budget_used() > timeout) {
 					aborted = true;
 					timed_out = true;
 				}
 			}
 
+			void check_checkpoint()
+			{
+				if (checkpoint_file.empty())
+					return;
+				auto request = pending_checkpoint_request();
+				if (request == no_checkpoint_request
+					&& !(checkpoint_interval && wall_time - last_checkpoint >= checkpoint_interval))
+					return;
+				pending_checkpoint_request() = no_checkpoint_request;
+				save_checkpoint();
+				last_checkpoint = wall_time;
+				if (request == checkpoint_and_stop) {
+					aborted = true;
+					interrupted = true;
+				}
+			}
+
+			// identifies the engine and the workload a checkpoint belongs to
+			virtual std::uint32_t engine_tag() const
+			{
+				return 0;
+			}
+
+			std::uint64_t workload_fingerprint() const
+			{
+				std::uint64_t f = jobs.size();
+				for (const auto &j : jobs)
+					f = f * 31 + j.get_key();
+				return f;
+			}
+
+			// engine-specific parts of a checkpoint
+			virtual void save_extra(Checkpoint_writer &) const
+			{
+			}
+
+			virtual void restore_extra(Checkpoint_reader &)
+			{
+			}
+
+			static void write_state(Checkpoint_writer &out, hash_value_t key,
+									const Interval<Time> &finish, Time earliest_release,
+									const Index_set::Set_type &words)
+			{
+				out.write(key);
+				out.write(finish.from());
+				out.write(finish.until());
+				out.write(earliest_release);
+				out.write(words);
+			}
+
+			static void write_intervals(Checkpoint_writer &out, const Response_times &r)
+			{
+				out.write<std::uint64_t>(r.size());
+				for (const auto &i : r) {
+					out.write(i.from());
+					out.write(i.until());
+				}
+			}
+
+			static void read_intervals(Checkpoint_reader &in, Response_times &r)
+			{
+				std::uint64_t n;
+				in.read(n);
+				r.clear();
+				for (std::uint64_t k = 0; k < n; k++) {
+					Time from, until;
+					in.read(from);
+					in.read(until);
+					r.push_back(Interval<Time>{from, until});
+				}
+			}
+
+			void save_checkpoint()
+			{
+				Checkpoint_writer out(checkpoint_file);
+
+				out.write<std::uint32_t>(checkpoint_version);
+				out.write(engine_tag());
+				out.write<std::uint32_t>(sizeof(Time));
+				out.write(workload_fingerprint());
+
+				out.write<std::uint64_t>(num_states);
+				out.write<std::uint64_t>(num_edges);
+				out.write<std::uint64_t>(width);
+				out.write<std::uint64_t>(number_of_subsumed_states());
+				out.write<std::uint64_t>(number_of_approximate_merges());
+				out.write(get_max_widening());
+				out.write<std::uint64_t>(current_job_count);
+				out.write(aborted);
+				out.write(timed_out);
+				out.write(observed_deadline_miss);
+				out.write(memory_stage);
+				out.write<double>(cpu_time);
+				out.write<double>(process_time);
+				out.write<double>(wall_time);
+
+				write_intervals(out, rta);
+				write_intervals(out, sta);
+				out.write(has_response_times);
+				save_extra(out);
+
+				// the frontier: states in memory (with their place in the
+				// queue), then states on disk
+				out.write<std::uint64_t>(next_todo_seq);
+				out.write<std::uint64_t>(todo.size() - subsumed.size());
+				for (auto q = todo; !q.empty(); q.pop()) {
+					State_ref s = q.top().state;
+					if (subsumed.count(s))
+						continue;
+					out.write(q.top().seq);
+					write_state(out, s->get_key(), s->finish_range(),
+								s->earliest_job_release(), s->get_scheduled_jobs().words());
+				}
+				out.write<std::uint64_t>(spill ? spill->size() : 0);
+				if (spill)
+					spill->for_each_pending([&out](const typename Spilled_frontier<Time>::Record &r) {
+						write_state(out, r.key, Interval<Time>{r.finish_from, r.finish_until},
+									r.earliest_release, r.words);
+					});
+
+				out.commit();
+			}
+
+			// Restore the exploration from a checkpoint, if there is one.
+			void resume_from(const std::string &file)
+			{
+				Checkpoint_reader in(file);
+				if (!in.exists())
+					return;
+
+				std::uint32_t version, tag, time_size;
+				std::uint64_t fingerprint;
+				in.read(version);
+				if (version != checkpoint_version)
+					in.mismatch("this version");
+				in.read(tag);
+				in.read(time_size);
+				if (tag != engine_tag() || time_size != sizeof(Time))
+					in.mismatch("the analysis options");
+				in.read(fingerprint);
+				if (fingerprint != workload_fingerprint())
+					in.mismatch("the workload");
+
+				std::uint64_t count;
+				in.read(count);
+				num_states = count;
+				in.read(count);
+				num_edges = count;
+				in.read(count);
+				width = count;
+				in.read(count);
+				num_subsumed = count;
+				in.read(count);
+				num_approximate_merges = count;
+				in.read(max_widening);
+				in.read(count);
+				current_job_count = count;
+				in.read(aborted);
+				in.read(timed_out);
+				in.read(observed_deadline_miss);
+				in.read(memory_stage);
+				double elapsed;
+				in.read(elapsed);
+				cpu_time.add(elapsed);
+				in.read(elapsed);
+				process_time.add(elapsed);
+				in.read(elapsed);
+				wall_time.add(elapsed);
+				last_checkpoint = wall_time;
+
+				read_intervals(in, rta);
+				read_intervals(in, sta);
+				in.read(has_response_times);
+				if (rta.size() != jobs.size() || sta.size() != jobs.size()
+					|| has_response_times.size() != jobs.size())
+					in.mismatch("the workload");
+				restore_extra(in);
+				std::uint64_t queued_seq;
+				in.read(queued_seq);
+
+				// states that were on disk go back to disk if this run is
+				// out of core, too; otherwise they are queued after the others
+				for (int on_disk = 0; on_disk < 2; on_disk++) {
+					in.read(count);
+					for (std::uint64_t i = 0; i < count; i++) {
+						std::uint64_t seq = 0;
+						if (!on_disk)
+							in.read(seq);
+						typename Spilled_frontier<Time>::Record r;
+						in.read(r.key);
+						in.read(r.finish_from);
+						in.read(r.finish_until);
+						in.read(r.earliest_release);
+						in.read(r.words);
+						if (on_disk && spill) {
+							spill->push(r);
+							continue;
+						}
+						// spilled states are only counted once read back
+						if (on_disk)
+							num_states++;
+						State_ref s_ref = new State(Job_set{std::move(r.words)},
+													Interval<Time>{r.finish_from, r.finish_until},
+													r.earliest_release, r.key);
+						if (on_disk)
+							push_todo(s_ref);
+						else
+							todo.push(Todo_entry{s_ref, seq});
+						if (!spill)
+							index_state(s_ref);
+						state_bytes += footprint(*s_ref);
+					}
+					// states queued from now on come after the restored ones
+					if (!on_disk)
+						next_todo_seq = queued_seq;
+				}
+				resumed = true;
+			}
+
+			// close the current block of layers once it is complete (or the
+			// exploration is over)
+			void trace_layers(bool finished)
+			{
+				if (!finished && current_job_count < trace_first_layer + layers_per_trace_span)
+					return;
+				double now = trace().now();
+				std::size_t last = finished ? current_job_count : current_job_count - 1;
+				trace().complete("exploration",
+								 "layers " + std::to_string(trace_first_layer) + "-" + std::to_string(last),
+								 trace_block_start, now,
+								 "\"states\": " + std::to_string(num_states - trace_first_state)
+								 + ", \"front\": " + std::to_string(todo.size()));
+				trace_first_layer = current_job_count;
+				trace_first_state = num_states;
+				trace_block_start = now;
+			}
+
+			void start_progress()
+			{
+				progress_start = last_progress = wall_time;
+				progress_first_layer = current_job_count;
+				progress_states = num_states;
+				progress_merges = num_merges;
+			}
+
+			void check_progress()
+			{
+				if (!progress_interval || --progress_countdown)
+					return;
+				progress_countdown = progress_stride;
+				if (wall_time - last_progress >= progress_interval)
+					report_progress(false);
+			}
+
+			// one JSON line with the depth, the front, the rates since the
+			// last report, and the remaining layers (with a guess of the
+			// remaining time based on the layers explored so far)
+			void report_progress(bool finished)
+			{
+				double now = wall_time;
+				double elapsed = std::max(now - last_progress, 1E-9);
+				std::size_t remaining = jobs.size() - current_job_count;
+				std::size_t front = todo.size() + (spill ? spill->size() : 0);
+
+				std::ostringstream line;
+				line << "{\"label\": \"" << Trace::escape(progress_label) << "\""
+					 << ", \"time\": " << now
+					 << ", \"depth\": " << current_job_count
+					 << ", \"jobs\": " << jobs.size()
+					 << ", \"front\": " << front
+					 << ", \"states\": " << num_states
+					 << ", \"states_per_s\": " << (num_states - progress_states) / elapsed
+					 << ", \"merges_per_s\": " << (num_merges - progress_merges) / elapsed
+					 << ", \"rss\": " << resident_set_bytes()
+					 << ", \"remaining_layers\": " << remaining
+					 << ", \"eta\": ";
+				if (finished)
+					line << 0;
+				else if (current_job_count > progress_first_layer)
+					line << (now - progress_start) / (current_job_count - progress_first_layer) * remaining;
+				else
+					line << "null";
+				line << ", \"done\": " << (finished ? "true" : "false") << "}";
+				progress().write(line.str());
+
+				last_progress = now;
+				progress_states = num_states;
+				progress_merges = num_merges;
+			}
+
 			void check_depth_abort()
 			{
 				if (max_depth && current_job_count == max_depth
-					&& todo.empty()) {
+					&& todo.empty() && (!spill || spill->empty())) {
 					aborted = true;
 				}
 			}
 
 			void done_with_current_state()
 			{
-				State_ref s = todo.top();
+				State_ref s = todo.top().state;
 				// remove from TODO list
 				todo.pop();
 				current_job_count = s->get_scheduled_jobs().size();
+				if (trace().enabled())
+					trace_layers(false);
 
 #ifndef CONFIG_COLLECT_SCHEDULE_GRAPH
 				// If we don't need to collect all states, we can remove
 				// all those that we are done with, which saves a lot of
 				// memory.
 
-				// remove from lookup map
-				auto matches = states_by_key.equal_range(s->get_key());
-				bool deleted = false;
-				for (auto it = matches.first; it != matches.second; it++)
-					if (it->second == s) {
-						states_by_key.erase(it);
-						deleted = true;
-						break;
-					}
-				assert(deleted);
+				// remove from lookup map (states loaded from disk are not in it)
+				if (!spill)
+					unindex_state(s);
 
 				// delete from master sequence to free up memory
+				state_bytes -= footprint(*s);
 				delete s;
 #endif
 			}
@@ -674,13 +1477,13 @@ namespace NP {
 			Time next_eligible_job_ready(const State& s) {
 				const Scheduled& already_scheduled = s.get_scheduled_jobs();
 
-				for (auto it = jobs_by_latest_arrival.begin(); it != jobs_by_latest_arrival.end(); it++) {
-					const Job<Time>& j = *(it->second);
-
+				for (std::size_t k = 0; k < jobs_by_latest_arrival.size(); k++) {
 					// not relevant if already scheduled
-					if (!incomplete(already_scheduled, j))
+					if (already_scheduled.contains(jobs_by_latest_arrival.job_index(k)))
 						continue;
 
+					const Job<Time>& j = jobs_by_latest_arrival.job(k);
+
 					auto t = std::max(j.latest_arrival(), s.latest_finish_time());
 
 					if (priority_eligible(s, j, t) && iip_eligible(s, j, t))
@@ -696,6 +1499,8 @@ namespace NP {
 					const State &s,
 					const Job<Time>& j)
 			{
+				NP_STAT(Phase_timer timer(stats.latest_finish_time_time));
+
 				Time other_certain_start =
 						next_certain_higher_priority_job_release(s, j);
 
@@ -729,41 +1534,45 @@ namespace NP {
 
 			Interval<Time> next_finish_times(const State &s, const Job<Time> &j)
 			{
-				auto i = index_of(j);
-
-				if (abort_actions[i]) {
-					// complicated case -- need to take aborts into account
+				NP_IF_CONSTEXPR (With_aborts) {
+					auto i = index_of(j);
+					if (abort_actions[i])
+						return next_finish_times_with_abort(s, j, *abort_actions[i]);
+				}
 
-					auto et = abort_actions[i]->earliest_trigger_time();
+				// standard case -- this job is never aborted or skipped
+				return Interval<Time>{
+						next_earliest_finish_time(s, j),
+						next_latest_finish_time(s, j)
+				};
+			}
 
-					// Rule: if we're certainly past the trigger, the job is
-					//       completely skipped.
+			// complicated case -- need to take aborts into account
+			Interval<Time> next_finish_times_with_abort(const State &s, const Job<Time> &j,
+														const Abort_action<Time> &a)
+			{
+				auto et = a.earliest_trigger_time();
 
-					if (s.earliest_finish_time() >= et)
-						// job doesn't even start, is skipped immediately
-						return s.finish_range();
+				// Rule: if we're certainly past the trigger, the job is
+				//       completely skipped.
 
-					// Otherwise, it might start execution. Let's compute the
-					// regular and aborted completion times.
+				if (s.earliest_finish_time() >= et)
+					// job doesn't even start, is skipped immediately
+					return s.finish_range();
 
-					auto eft = next_earliest_finish_time(s, j);
-					auto lft = next_latest_finish_time(s, j);
+				// Otherwise, it might start execution. Let's compute the
+				// regular and aborted completion times.
 
-					auto eat = next_earliest_job_abortion(*abort_actions[i]);
-					auto lat = next_latest_job_abortion(*abort_actions[i]);
+				auto eft = next_earliest_finish_time(s, j);
+				auto lft = next_latest_finish_time(s, j);
 
-					return Interval<Time>{
-							std::min(eft, eat),
-							std::min(lft, lat)
-					};
+				auto eat = next_earliest_job_abortion(a);
+				auto lat = next_latest_job_abortion(a);
 
-				} else {
-					// standard case -- this job is never aborted or skipped
-					return Interval<Time>{
-							next_earliest_finish_time(s, j),
-							next_latest_finish_time(s, j)
-					};
-				}
+				return Interval<Time>{
+						std::min(eft, eat),
+						std::min(lft, lat)
+				};
 			}
 
 			void process_new_edge(
@@ -777,7 +1586,8 @@ namespace NP {
 				// update statistics
 				num_edges++;
 #ifdef CONFIG_COLLECT_SCHEDULE_GRAPH
-				edges.push_back(std::make_unique<Edge>(&j, &from, &to, finish_range));
+				if (memory_stage == Memory_stage::normal)
+					edges.push_back(std::make_unique<Edge>(&j, &from, &to, finish_range));
 #endif
 			}
 
@@ -799,11 +1609,13 @@ namespace NP {
 
 				while (not_done() && !aborted) {
 					const State& s = next_state();
+					NP_STAT(Phase_timer expansion_timer(stats.expansion_time));
+					NP_STAT(auto job_iterations_before = stats.job_iterations);
 
 					DM("\n==================================================="
 							   << std::endl);
 					DM("Looking at: S"
-							   << (todo.top() - *states.begin() + 1)
+							   << (todo.top().state - *states.begin() + 1)
 							   << " " << s << std::endl);
 
 					// Identify relevant interval for next job
@@ -835,8 +1647,12 @@ namespace NP {
 							aborted = true;
 					}
 
+					NP_STAT(stats.job_iterations_per_state.record(stats.job_iterations - job_iterations_before));
 					done_with_current_state();
 					check_cpu_timeout();
+					check_memory_budget();
+					check_checkpoint();
+					check_progress();
 					check_depth_abort();
 				}
 			}
@@ -863,26 +1679,13 @@ namespace NP {
 
 				auto k = s.next_key(j);
 
-				auto r = states_by_key.equal_range(k);
-
-				if (r.first != r.second) {
-					Job_set sched_jobs{s.get_scheduled_jobs(), index_of(j)};
-
-					for (auto it = r.first; it != r.second; it++) {
-						State &found = *it->second;
-
-						// key collision if the job sets don't match exactly
-						if (found.get_scheduled_jobs() != sched_jobs)
-							continue;
-
-						// cannot merge without loss of accuracy if the
-						// intervals do not overlap
-						if (!finish_range.intersects(found.finish_range()))
-							continue;
-
-						// great, we found a match and can merge the states
-						found.update_finish_range(finish_range);
-						process_new_edge(s, found, j, finish_range);
+				if (subsumption || states_by_key.find(k) != states_by_key.end()) {
+					State *found = merge_into_existing_state(
+							k, Job_set{s.get_scheduled_jobs(), index_of(j)}, finish_range);
+					if (found) {
+						// great, we found a match and merged the states
+						num_merges++;
+						process_new_edge(s, *found, j, finish_range);
 						return;
 					}
 				}
@@ -904,11 +1707,13 @@ namespace NP {
 
 				while (not_done() && !aborted) {
 					const State& s = next_state();
+					NP_STAT(Phase_timer expansion_timer(stats.expansion_time));
+					NP_STAT(auto job_iterations_before = stats.job_iterations);
 
 					DM("\n==================================================="
 							   << std::endl);
 					DM("Looking at: S"
-							   << (todo.top() - *states.begin() + 1)
+							   << (todo.top().state - *states.begin() + 1)
 							   << " " << s << std::endl);
 
 					// Identify relevant interval for next job
@@ -942,8 +1747,12 @@ namespace NP {
 						DM(":: Didn't find any possible successors." << std::endl);
 					}
 
+					NP_STAT(stats.job_iterations_per_state.record(stats.job_iterations - job_iterations_before));
 					done_with_current_state();
 					check_cpu_timeout();
+					check_memory_budget();
+					check_checkpoint();
+					check_progress();
 					check_depth_abort();
 				}
 			}
@@ -994,7 +1803,7 @@ namespace NP {
 
 
 			friend std::ostream& operator<< (std::ostream& out,
-			                                 const State_space<Time, IIP>& space)
+			                                 const State_space<Time, IIP, With_aborts>& space)
 			{
 					std::map<const Schedule_state<Time>*, unsigned int> state_id;
 					unsigned int i = 1;
@@ -0,0 +1,334 @@
+#ifndef SPILL_HPP
+#define SPILL_HPP
+
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+#include <map>
+#include <queue>
+#include <algorithm>
+#include <stdexcept>
+
+#include "jobs.hpp"
+#include "index_set.hpp"
+
+namespace NP {
+
+	namespace Uniproc {
+
+		// Unexplored states that have been moved out of memory, kept in one
+		// temporary file per depth (number of scheduled jobs).
+		//
+		// A layer is read back only once all states of smaller depth have
+		// been explored, so no more states can be added to it. Reading it
+		// back sorts the layer externally (sorted runs of bounded size,
+		// then a k-way merge) by key, job set and earliest finish time,
+		// which puts mergeable states next to each other. Adjacent states
+		// with the same job set and intersecting finish ranges are merged,
+		// as in the in-memory exploration. Memory use is bounded by the run
+		// size, independently of the width of the layer.
+		template<class Time> class Spilled_frontier
+		{
+		public:
+
+			struct Record {
+				hash_value_t key;
+				Time finish_from, finish_until;
+				Time earliest_release;
+				Index_set::Set_type words;
+
+				bool operator<(const Record &other) const
+				{
+					if (key != other.key)
+						return key < other.key;
+					if (words != other.words)
+						return words < other.words;
+					return finish_from < other.finish_from;
+				}
+
+				void absorb(const Record &other)
+				{
+					finish_until = std::max(finish_until, other.finish_until);
+					earliest_release = std::min(earliest_release, other.earliest_release);
+				}
+
+				std::size_t bytes() const
+				{
+					return sizeof(Record) + words.size() * sizeof(Index_set::Word);
+				}
+			};
+
+			// Finish ranges that are at most `adjacent` apart are merged,
+			// too, and so are those at most `tolerance` apart, at a loss of
+			// accuracy.
+			Spilled_frontier(std::size_t run_bytes, Time adjacent = 0, Time tolerance = 0)
+					: run_bytes(std::max(run_bytes, std::size_t(1)))
+					, adjacent(adjacent)
+					, slack(std::max(adjacent, tolerance))
+					, num_pending(0)
+					, num_subsumed(0)
+					, num_approximate_merges(0)
+					, max_widening(0)
+			{
+			}
+
+			~Spilled_frontier()
+			{
+				for (auto &l : layers)
+					std::fclose(l.second);
+				close_runs();
+			}
+
+			// write a state to the file of its depth
+			void push(hash_value_t key, const Interval<Time> &finish,
+					  Time earliest_release, const Index_set &jobs)
+			{
+				push(Record{key, finish.from(), finish.until(), earliest_release, jobs.words()});
+			}
+
+			void push(const Record &r)
+			{
+				std::size_t depth = Index_set(r.words).size();
+				auto l = layers.find(depth);
+				if (l == layers.end())
+					l = layers.emplace(depth, new_file()).first;
+				write(l->second, r);
+				num_pending++;
+			}
+
+			// Visit all states on disk that have not been read back yet,
+			// without consuming them (e.g., to take a checkpoint).
+			template<class Visitor> void for_each_pending(Visitor visit)
+			{
+				auto h = heads;
+				for (; !h.empty(); h.pop())
+					visit(h.top().first);
+				for (auto f : runs)
+					visit_rest(f, visit);
+				for (auto &l : layers) {
+					std::rewind(l.second);
+					visit_rest(l.second, visit);
+					std::fseek(l.second, 0, SEEK_END);
+				}
+			}
+
+			// number of states written out and not yet read back
+			std::size_t size() const
+			{
+				return num_pending;
+			}
+
+			bool empty() const
+			{
+				return !num_pending && heads.empty();
+			}
+
+			// number of states merged because they were adjacent
+			unsigned long number_of_subsumed_states() const
+			{
+				return num_subsumed;
+			}
+
+			// number of states merged despite a gap, and the largest gap
+			unsigned long number_of_approximate_merges() const
+			{
+				return num_approximate_merges;
+			}
+
+			Time get_max_widening() const
+			{
+				return max_widening;
+			}
+
+			// Prepare the shallowest layer for reading. Returns false if
+			// there are no more states on disk.
+			bool open_next_layer()
+			{
+				close_runs();
+				if (layers.empty())
+					return false;
+
+				std::FILE *layer = layers.begin()->second;
+				layers.erase(layers.begin());
+				std::rewind(layer);
+
+				// split the layer into sorted, locally merged runs
+				std::vector<Record> run;
+				std::size_t bytes = 0;
+				Record r;
+				while (read(layer, r)) {
+					num_pending--;
+					bytes += r.bytes();
+					run.push_back(std::move(r));
+					if (bytes >= run_bytes) {
+						write_run(run);
+						bytes = 0;
+					}
+				}
+				write_run(run);
+				std::fclose(layer);
+
+				for (std::size_t i = 0; i < runs.size(); i++) {
+					std::rewind(runs[i]);
+					advance(i);
+				}
+				return true;
+			}
+
+			// Next merged state of the open layer. Returns false at the end
+			// of the layer.
+			bool next(Record &out)
+			{
+				if (heads.empty())
+					return false;
+				std::size_t i = heads.top().second;
+				out = std::move(heads.top().first);
+				heads.pop();
+				advance(i);
+				while (!heads.empty() && can_absorb(out, heads.top().first)) {
+					i = heads.top().second;
+					absorb(out, heads.top().first);
+					heads.pop();
+					advance(i);
+				}
+				return true;
+			}
+
+		private:
+
+			typedef std::pair<Record, std::size_t> Head;
+
+			struct Later {
+				bool operator()(const Head &a, const Head &b) const
+				{
+					return b.first < a.first;
+				}
+			};
+
+			std::size_t run_bytes;
+			Time adjacent, slack;
+			std::size_t num_pending;
+			unsigned long num_subsumed;
+			unsigned long num_approximate_merges;
+			Time max_widening;
+
+			std::map<std::size_t, std::FILE*> layers;
+
+			// sorted runs of the open layer and their current records
+			std::vector<std::FILE*> runs;
+			std::priority_queue<Head, std::vector<Head>, Later> heads;
+
+			// same job set and intersecting (or close enough) finish ranges,
+			// given that b does not start before a
+			bool can_absorb(const Record &a, const Record &b) const
+			{
+				return a.key == b.key && a.words == b.words
+					   && b.finish_from - slack <= a.finish_until;
+			}
+
+			void absorb(Record &a, const Record &b)
+			{
+				if (b.finish_from > a.finish_until) {
+					Time gap = b.finish_from - a.finish_until;
+					if (gap <= adjacent)
+						num_subsumed++;
+					else {
+						num_approximate_merges++;
+						max_widening = std::max(max_widening, gap);
+					}
+				}
+				a.absorb(b);
+			}
+
+			static std::FILE* new_file()
+			{
+				// removed automatically when closed or at exit
+				std::FILE *f = std::tmpfile();
+				if (!f)
+					throw std::runtime_error("cannot create a temporary file for the spilled frontier");
+				return f;
+			}
+
+			static void write(std::FILE *f, const Record &r)
+			{
+				std::uint32_t n = r.words.size();
+				bool ok = std::fwrite(&r.key, sizeof(r.key), 1, f) == 1
+						  && std::fwrite(&r.finish_from, sizeof(Time), 1, f) == 1
+						  && std::fwrite(&r.finish_until, sizeof(Time), 1, f) == 1
+						  && std::fwrite(&r.earliest_release, sizeof(Time), 1, f) == 1
+						  && std::fwrite(&n, sizeof(n), 1, f) == 1
+						  && std::fwrite(r.words.data(), sizeof(Index_set::Word), n, f) == n;
+				if (!ok)
+					throw std::runtime_error("cannot write the spilled frontier");
+			}
+
+			static bool read(std::FILE *f, Record &r)
+			{
+				std::uint32_t n;
+				if (std::fread(&r.key, sizeof(r.key), 1, f) != 1)
+					return false;
+				bool ok = std::fread(&r.finish_from, sizeof(Time), 1, f) == 1
+						  && std::fread(&r.finish_until, sizeof(Time), 1, f) == 1
+						  && std::fread(&r.earliest_release, sizeof(Time), 1, f) == 1
+						  && std::fread(&n, sizeof(n), 1, f) == 1;
+				if (ok) {
+					r.words.resize(n);
+					ok = std::fread(r.words.data(), sizeof(Index_set::Word), n, f) == n;
+				}
+				if (!ok)
+					throw std::runtime_error("truncated spilled frontier");
+				return true;
+			}
+
+			void write_run(std::vector<Record> &run)
+			{
+				if (run.empty())
+					return;
+				std::sort(run.begin(), run.end());
+				std::FILE *f = new_file();
+				Record acc = std::move(run[0]);
+				for (std::size_t i = 1; i < run.size(); i++) {
+					if (can_absorb(acc, run[i]))
+						absorb(acc, run[i]);
+					else {
+						write(f, acc);
+						acc = std::move(run[i]);
+					}
+				}
+				write(f, acc);
+				runs.push_back(f);
+				run.clear();
+			}
+
+			// visit the records from the current position of f to its end,
+			// where writing continues afterwards
+			template<class Visitor> static void visit_rest(std::FILE *f, Visitor &visit)
+			{
+				auto pos = std::ftell(f);
+				Record r;
+				while (read(f, r))
+					visit(r);
+				std::fseek(f, pos, SEEK_SET);
+			}
+
+			// load the next record of run i, if any
+			void advance(std::size_t i)
+			{
+				Record r;
+				if (read(runs[i], r))
+					heads.emplace(std::move(r), i);
+			}
+
+			void close_runs()
+			{
+				for (auto f : runs)
+					std::fclose(f);
+				runs.clear();
+				heads = std::priority_queue<Head, std::vector<Head>, Later>();
+			}
+		};
+
+	}
+}
+
+#endif
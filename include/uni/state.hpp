@@ -58,21 +58,32 @@ namespace NP {
 			{
 			}
 
-			// transition: new state by scheduling a set of jobs in an existing state
+			// transition: new state by scheduling a set of jobs in an existing state,
+			// where `scheduled` is the union of from's jobs and the reduction set
 			Schedule_state(
 					const Schedule_state& from,
 					const Reduction_set<Time>& r,
-					const std::vector<std::size_t>& idxs,
+					Job_set scheduled,
 					Interval<Time> ftimes,
 					const Time next_earliest_release)
 					: finish_time{ftimes}
-					, scheduled_jobs{from.scheduled_jobs}
+					, scheduled_jobs{std::move(scheduled)}
 					, lookup_key{from.next_key(r)}
 					, earliest_pending_release{next_earliest_release}
 			{
-				for (std::size_t idx : idxs) {
-					scheduled_jobs.add(idx);
-				}
+			}
+
+			// restore a state that was written out to disk
+			Schedule_state(
+					Job_set scheduled,
+					Interval<Time> ftimes,
+					const Time next_earliest_release,
+					hash_value_t key)
+					: finish_time{ftimes}
+					, scheduled_jobs{std::move(scheduled)}
+					, lookup_key{key}
+					, earliest_pending_release{next_earliest_release}
+			{
 			}
 
 
@@ -102,6 +113,12 @@ namespace NP {
 				finish_time.widen(update);
 			}
 
+			// merge a disjoint finish range, too (loses accuracy)
+			void widen_finish_range(const Interval<Time> &update)
+			{
+				finish_time.widen(update);
+			}
+
 			hash_value_t get_key() const
 			{
 				return lookup_key;
@@ -0,0 +1,118 @@
+#ifndef EXPLORATION_STATISTICS_HPP
+#define EXPLORATION_STATISTICS_HPP
+
+#include <ostream>
+#include <chrono>
+
+#include "uni/reduction_set.hpp"
+
+namespace NP {
+
+	namespace Uniproc {
+
+		// Hot-path counters and per-phase timers of the exploration engines.
+		// They are only updated if CONFIG_COLLECT_STATISTICS is defined (see
+		// NP_STAT in config.h); otherwise the updates are compiled out.
+		class Exploration_statistics {
+
+		public:
+
+			// outcomes of is_eligible_successor()
+			unsigned long eligibility_checks, eligible;
+			unsigned long rejected_complete, rejected_not_ready, rejected_priority,
+					rejected_not_next, rejected_iip;
+
+			// lookups of an existing state to merge a transition into
+			unsigned long merge_attempts, merges, key_collisions;
+
+			// reduction-set construction (partial-order reduction only)
+			unsigned long reduction_set_attempts, reduction_set_iterations;
+			Log2_histogram reduction_set_sizes;
+
+			// iterations of the pending-job loops, in total and per state
+			unsigned long long job_iterations;
+			Log2_histogram job_iterations_per_state;
+
+			// time spent per phase (in seconds)
+			double expansion_time, merge_time, latest_finish_time_time;
+
+			Exploration_statistics()
+					: eligibility_checks{0}, eligible{0}
+					, rejected_complete{0}, rejected_not_ready{0}, rejected_priority{0}
+					, rejected_not_next{0}, rejected_iip{0}
+					, merge_attempts{0}, merges{0}, key_collisions{0}
+					, reduction_set_attempts{0}, reduction_set_iterations{0}
+					, job_iterations{0}
+					, expansion_time{0}, merge_time{0}, latest_finish_time_time{0} {}
+
+			void merge(const Exploration_statistics &other) {
+				eligibility_checks += other.eligibility_checks;
+				eligible += other.eligible;
+				rejected_complete += other.rejected_complete;
+				rejected_not_ready += other.rejected_not_ready;
+				rejected_priority += other.rejected_priority;
+				rejected_not_next += other.rejected_not_next;
+				rejected_iip += other.rejected_iip;
+				merge_attempts += other.merge_attempts;
+				merges += other.merges;
+				key_collisions += other.key_collisions;
+				reduction_set_attempts += other.reduction_set_attempts;
+				reduction_set_iterations += other.reduction_set_iterations;
+				reduction_set_sizes.merge(other.reduction_set_sizes);
+				job_iterations += other.job_iterations;
+				job_iterations_per_state.merge(other.job_iterations_per_state);
+				expansion_time += other.expansion_time;
+				merge_time += other.merge_time;
+				latest_finish_time_time += other.latest_finish_time_time;
+			}
+
+			void write_json(std::ostream &out) const {
+				out << "{\n"
+					<< "  \"eligibility\": {\"checks\": " << eligibility_checks
+					<< ", \"eligible\": " << eligible
+					<< ", \"rejected\": {\"complete\": " << rejected_complete
+					<< ", \"not_ready\": " << rejected_not_ready
+					<< ", \"priority\": " << rejected_priority
+					<< ", \"not_potentially_next\": " << rejected_not_next
+					<< ", \"iip\": " << rejected_iip << "}},\n"
+					<< "  \"merging\": {\"attempts\": " << merge_attempts
+					<< ", \"successes\": " << merges
+					<< ", \"key_collisions\": " << key_collisions << "},\n"
+					<< "  \"reduction_sets\": {\"attempts\": " << reduction_set_attempts
+					<< ", \"iterations\": " << reduction_set_iterations
+					<< ", \"sizes\": ";
+				reduction_set_sizes.write_json(out);
+				out << "},\n"
+					<< "  \"job_iterations\": {\"total\": " << job_iterations
+					<< ", \"per_state\": ";
+				job_iterations_per_state.write_json(out);
+				out << "},\n"
+					<< "  \"time\": {\"expansion\": " << expansion_time
+					<< ", \"merging\": " << merge_time
+					<< ", \"next_latest_finish_time\": " << latest_finish_time_time << "}\n"
+					<< "}\n";
+			}
+		};
+
+		// adds the lifetime of the timer to a phase total (in seconds)
+		class Phase_timer {
+
+		public:
+
+			Phase_timer(double &total) : total(total), start(Clock::now()) {}
+
+			~Phase_timer() {
+				total += std::chrono::duration<double>(Clock::now() - start).count();
+			}
+
+		private:
+
+			typedef std::chrono::steady_clock Clock;
+
+			double &total;
+			Clock::time_point start;
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,217 @@
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <cctype>
+
+#include "OptionParser.h"
+
+#include "io.hpp"
+#include "generator.hpp"
+
+// Generates random task sets in the input format of run_analysis.
+
+static std::vector<std::string> split_list(const std::string &list)
+{
+	std::vector<std::string> items;
+	std::stringstream in(list);
+	std::string item;
+	while (std::getline(in, item, ','))
+		if (!item.empty())
+			items.push_back(item);
+	return items;
+}
+
+// a named distribution, or a list of periods
+static NP::Period_distribution parse_periods(const std::string &arg)
+{
+	if (arg.empty() || (!isdigit(arg[0]) && arg[0] != '-'))
+		return NP::period_distribution(arg);
+	NP::Period_distribution d;
+	for (auto &p : split_list(arg))
+		d.periods.push_back(std::stoll(p));
+	return d;
+}
+
+// the k-th of several output files (with the extension that run_analysis
+// names its outputs after, if FILE has none)
+static std::string output_name(const std::string &fname, unsigned int k)
+{
+	std::string name = fname;
+	auto p = name.find(".prec.yaml");
+	if (p == std::string::npos)
+		p = name.find(".yaml");
+	if (p == std::string::npos)
+		return name + "-" + std::to_string(k) + ".prec.yaml";
+	return name.insert(p, "-" + std::to_string(k));
+}
+
+int main(int argc, char **argv) {
+	auto parser = optparse::OptionParser();
+
+	parser.description("Generates random task sets (DAGs with task chains) in "
+					   "the input format of run_analysis.");
+
+	parser.usage("usage: %prog [OPTIONS]...");
+
+	parser.add_option("-n", "--tasks").dest("tasks").metavar("NUMBER")
+			.help("number of tasks (default: 20)")
+			.set_default("20");
+
+	parser.add_option("-m", "--pes").dest("pes").metavar("NUMBER")
+			.help("number of PEs (default: 2)")
+			.set_default("2");
+
+	parser.add_option("--mapping").dest("mapping")
+			.choices({"round-robin", "random"}).set_default("round-robin")
+			.help("how tasks are mapped to PEs (default: round-robin)");
+
+	parser.add_option("-u", "--utilization").dest("utilization").metavar("U")
+			.help("utilisation of each PE (default: 0.5)")
+			.set_default("0.5");
+
+	parser.add_option("--pe-utilization").dest("pe_utilization").metavar("U0,U1,...")
+			.help("utilisation of each PE, in PE order; PEs not listed get "
+				  "--utilization (default: none)")
+			.set_default("");
+
+	parser.add_option("--split").dest("split")
+			.choices({"uunifast", "uniform"}).set_default("uunifast")
+			.help("how the utilisation of a PE is divided among its tasks "
+				  "(default: uunifast)");
+
+	parser.add_option("-p", "--periods").dest("periods").metavar("PERIODS")
+			.help("harmonic, loose, automotive (periods weighted as in automotive "
+				  "applications), automotive-uniform, or a list of periods in "
+				  "microseconds (default: harmonic)")
+			.set_default("harmonic");
+
+	parser.add_option("--jitter").dest("jitter").metavar("FRACTION")
+			.help("release jitter as a fraction of the period (default: 0.01)")
+			.set_default("0.01");
+
+	parser.add_option("--bcet-ratio").dest("bcet_ratio").metavar("FRACTION")
+			.help("BCET as a fraction of the WCET (default: 0.1)")
+			.set_default("0.1");
+
+	parser.add_option("--shape").dest("shape")
+			.choices({"random", "layered"}).set_default("random")
+			.help("'random': any task may precede any later task; 'layered': "
+				  "edges only between adjacent layers (default: random)");
+
+	parser.add_option("--layers").dest("layers").metavar("NUMBER")
+			.help("number of layers of a layered DAG (default: chain length)")
+			.set_default("0");
+
+	parser.add_option("--edge-probability").dest("edge_probability").metavar("P")
+			.help("probability of an edge between two tasks that may be "
+				  "connected (default: 0.05)")
+			.set_default("0.05");
+
+	parser.add_option("--chains").dest("chains").metavar("NUMBER")
+			.help("number of task chains (default: 1)")
+			.set_default("1");
+
+	parser.add_option("-l", "--chain-length").dest("chain_length").metavar("NUMBER")
+			.help("number of tasks of each chain (default: 4)")
+			.set_default("4");
+
+	parser.add_option("-s", "--seed").dest("seed").metavar("NUMBER")
+			.help("seed of the first task set (default: 1)")
+			.set_default("1");
+
+	parser.add_option("-c", "--count").dest("count").metavar("NUMBER")
+			.help("number of task sets, with consecutive seeds; they are "
+				  "written to FILE-1.prec.yaml, FILE-2.prec.yaml, ...: the number "
+				  "goes before the .prec.yaml or .yaml extension of FILE, and "
+				  ".prec.yaml is added if FILE has neither (default: 1)")
+			.set_default("1");
+
+	parser.add_option("-o", "--output").dest("output").metavar("FILE")
+			.help("write the task set to FILE (default: stdout)")
+			.set_default("");
+
+	parser.add_option("--summary").dest("summary").set_default("0")
+			.action("store_const").set_const("1")
+			.help("print the hyperperiod and the number of jobs of each PE "
+				  "of each task set to stderr (default: off)");
+
+	auto options = parser.parse_args(argc, argv);
+
+	NP::Workload_parameters p;
+	p.num_tasks = (unsigned int) options.get("tasks");
+	p.num_pes = (unsigned int) options.get("pes");
+	p.mapping = (std::string) options.get("mapping") == "random"
+				? NP::Pe_mapping::random : NP::Pe_mapping::round_robin;
+	p.utilization = options.get("utilization");
+	p.split = (std::string) options.get("split") == "uniform"
+			  ? NP::Utilization_split::uniform : NP::Utilization_split::uunifast;
+	p.jitter = options.get("jitter");
+	p.bcet_ratio = options.get("bcet_ratio");
+	p.shape = (std::string) options.get("shape") == "layered"
+			  ? NP::Dag_shape::layered : NP::Dag_shape::random;
+	p.num_layers = (unsigned int) options.get("layers");
+	p.edge_probability = options.get("edge_probability");
+	p.num_chains = (unsigned int) options.get("chains");
+	p.chain_length = (unsigned int) options.get("chain_length");
+	p.seed = (unsigned long) options.get("seed");
+	unsigned int count = (unsigned int) options.get("count");
+	std::string output = options.get("output");
+	bool want_summary = options.get("summary");
+
+	try {
+		p.periods = parse_periods(options.get("periods"));
+		for (auto &u : split_list(options.get("pe_utilization")))
+			p.pe_utilization.push_back(std::stod(u));
+	} catch (std::exception &ex) {
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	if (!count) {
+		std::cerr << "Error: the number of task sets must be positive" << std::endl;
+		return 1;
+	}
+
+	if (count > 1 && output.empty()) {
+		std::cerr << "Error: several task sets need an output file" << std::endl;
+		return 1;
+	}
+
+	for (unsigned int k = 1; k <= count; k++) {
+		std::string fname = count > 1 ? output_name(output, k) : output;
+		try {
+			auto dag = NP::generate_dag<dtime_t>(p);
+
+			if (fname.empty())
+				NP::write_mr_dag(std::cout, dag);
+			else {
+				auto out = std::ofstream(fname, std::ios::out);
+				NP::write_mr_dag(out, dag);
+				out.close();
+				if (!out) {
+					std::cerr << "Error: cannot write " << fname << std::endl;
+					return 1;
+				}
+			}
+
+			if (want_summary) {
+				dag.calculate_hyperperiod();
+				auto generated = NP::generate_job_set<dtime_t>(dag);
+				std::cerr << (fname.empty() ? "-" : fname)
+						  << ", seed " << p.seed
+						  << ", hyperperiod " << dag.get_hyperperiod()
+						  << ", jobs per PE";
+				for (unsigned int pe = 0; pe < p.num_pes; pe++)
+					std::cerr << " "
+							  << (pe < generated.jobs_of_pe.size() ? generated.jobs_of_pe[pe].size() : 0);
+				std::cerr << std::endl;
+			}
+		} catch (std::exception &ex) {
+			std::cerr << "Error: " << ex.what() << std::endl;
+			return 1;
+		}
+		p.seed++;
+	}
+
+	return 0;
+}
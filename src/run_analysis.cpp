@@ -2,6 +2,8 @@
 #include <sstream>
 #include <fstream>
 #include <algorithm>
+#include <csignal>
+#include <cmath>
 
 #ifndef _WIN32
 
@@ -20,14 +22,19 @@
 #include "uni/por_criterion.hpp"
 #include "uni/reduction_set.hpp"
 #include "data_age_analysis.hpp"
+#include "chain_enumerator.hpp"
 #include "io.hpp"
 #include "clock.hpp"
+#include "checkpoint.hpp"
+#include "trace.hpp"
+#include "progress.hpp"
 
 
 #define MAX_PROCESSORS 512
 
 // command line options
 static bool want_naive;
+static std::string por_mode;
 static bool want_dense;
 static bool want_worst_case;
 
@@ -42,10 +49,38 @@ static unsigned int num_processors = 1;
 static bool want_dot_graph;
 #endif
 static double timeout;
+static Clock_source timeout_clock = Clock_source::thread_cpu;
+static std::size_t memory_limit = 0;
+static bool want_out_of_core = false;
+static bool want_subsumption = false;
+static double merge_tolerance = 0;
+static std::size_t merge_cap = 0;
+static bool want_checkpoints = false;
+static double checkpoint_interval = 0;
+static bool want_resume = false;
+static double progress_interval = 0;
 static unsigned int max_depth = 0;
 
+static NP::Chain_objective chain_objective = NP::Chain_objective::hop_count;
+
+static bool want_compact_time = true;
+static bool want_time_normalization = false;
+static double time_quantum = 0;
+
+static bool want_all_chains = false;
+static bool want_chain_window = false;
+static NP::Chain_enumeration_options chain_opts;
+
 static bool want_rta_file;
 
+static bool want_por_stats_file;
+
+#ifdef CONFIG_COLLECT_STATISTICS
+static bool want_exploration_stats_file;
+#endif
+
+static bool want_times_file;
+
 static bool continue_after_dl_miss = false;
 
 
@@ -54,123 +89,275 @@ template<class Time>
 struct Analysis_result {
 	bool schedulable = true;
 	bool timeout = false;
+	bool memory_exhausted = false;
 	unsigned long long number_of_states = 0, number_of_edges = 0, max_width = 0, number_of_jobs = 0;
-	double cpu_time = 0;
+	unsigned long long number_of_subsumed_states = 0;
+	// lossy merges of states whose finish ranges were apart, and the
+	// largest gap that was closed (in input time units)
+	unsigned long long number_of_approximate_merges = 0;
+	double max_widening = 0;
+	double cpu_time = 0, wall_time = 0;
+	// per-partition timing, as CSV lines
+	std::string partition_times_csv;
 	std::unordered_map<NP::JobID, Interval<Time>> rta;
 	std::unordered_map<NP::JobID, Interval<Time>> sta;
 	std::string graph;
 	std::string response_times_csv;
+	NP::Uniproc::Reduction_set_statistics por_stats;
+	NP::Uniproc::Exploration_statistics exploration_stats;
 };
 
-template<class Time, class Space>
-Analysis_result<Time> analyze(
-		std::istream &in, const std::string &fname) {
+// a parsed model, ready for job generation
+template<class Time>
+struct Prepared_model {
+	NP::dag<Time> dag;
+	// one time unit of the model, in input units
+	Time time_base = 1;
+	// chains are enumerated lazily instead of being stored in the dag
+	bool stream_chains = false;
+};
 
-	// first read the task set file
-	auto dag = NP::parse_mr_dag<Time>(in, want_worst_case);
+template<class Time>
+static Prepared_model<Time> prepare_model(std::istream &in) {
+	Prepared_model<Time> model;
+	auto &dag = model.dag;
+
+	{
+		NP::Trace_span span("analysis", "parse");
+
+		// first read the task set file
+		dag = NP::parse_mr_dag<Time>(in, want_worst_case);
 
-	// read task chains from file
-	NP::parse_task_chain(in, dag);
+		// read task chains from file
+		NP::parse_task_chain(in, dag);
+	}
+
+	// optionally analyse the model in a coarser time base; reported times
+	// are scaled back to input units
+	if (want_time_normalization || time_quantum > 0)
+		model.time_base = dag.normalize_time_base((Time) time_quantum);
 
 	//if task chains are not in the input file, use default chains
 	if (dag.get_task_chains().empty()) {
-//		dag.find_task_chains();
-		dag.find_longest_task_chain();
+		NP::Trace_span span("analysis", "chain selection");
+		if (want_all_chains) {
+			// chains are enumerated lazily, once, by the data-age analysis; a
+			// capped number of chains is stored right away instead
+			NP::Chain_enumerator<Time> chains(dag, chain_opts);
+			if (chain_opts.max_chains) {
+				typename NP::dag<Time>::Task_chain tc;
+				while (chains.next(tc))
+					dag.add_task_chain(tc);
+			} else {
+				model.stream_chains = true;
+				chains.require_observation_window();
+			}
+		} else {
+			dag.find_longest_task_chain(chain_objective);
+		}
 	}
 
+	// the hyperperiod of all tasks may overflow even if the one of the
+	// tasks affecting the analysed chains does not; a window bounded by
+	// chains does not need it
+	dag.bound_window_by_chains(want_chain_window);
+	if (!dag.has_chain_bounded_window())
+		dag.calculate_hyperperiod();
+	return model;
+}
+
+// set while an exploration runs and can act on checkpoint requests
+static volatile std::sig_atomic_t exploring = 0;
+
+// run the analysis engine on one per-PE problem and merge its results
+template<class Time, class Space>
+static void explore_problem(
+		const NP::Scheduling_problem<Time> &main_problem,
+		const NP::Analysis_options &opts,
+		Analysis_result<Time> &main_result,
+		std::ostream &graph) {
+
+	NP::Trace_span span("analysis", "explore PE "
+		+ std::to_string(main_problem.jobs.empty() ? 0 : main_problem.jobs[0].get_pe()));
+
+	exploring = 1;
+	auto space = Space::explore(main_problem, opts);
+	exploring = 0;
+	// a SIGTERM that arrived after the exploration's last check
+	if (NP::pending_checkpoint_request() == NP::checkpoint_and_stop) {
+		std::signal(SIGTERM, SIG_DFL);
+		std::raise(SIGTERM);
+	}
+	span.set_args("\"jobs\": " + std::to_string(main_problem.jobs.size())
+				  + ", \"states\": " + std::to_string(space.number_of_states()));
+
+	if (space.was_interrupted()) {
+		std::cerr << "interrupted; checkpoint written to "
+				  << opts.checkpoint_file << std::endl;
+		exit(4);
+	}
+
+	// Extract the analysis results
+	main_result.schedulable = main_result.schedulable && space.is_schedulable();
+	main_result.timeout = main_result.timeout || space.was_timed_out();
+	main_result.memory_exhausted = main_result.memory_exhausted || space.was_memory_exhausted();
+	main_result.number_of_states += space.number_of_states();
+	main_result.number_of_edges += space.number_of_edges();
+	main_result.number_of_subsumed_states += space.number_of_subsumed_states();
+	main_result.number_of_approximate_merges += space.number_of_approximate_merges();
+	// in model time units, scaled once all partitions are done
+	main_result.max_widening = std::max(main_result.max_widening, (double) space.get_max_widening());
+	main_result.max_width = std::max(main_result.max_width,
+									 (unsigned long long) space.max_exploration_front_width());
+	main_result.number_of_jobs += main_problem.jobs.size();
+	main_result.cpu_time += space.get_cpu_time();
+	main_result.wall_time += space.get_wall_time();
+	main_result.partition_times_csv += std::to_string(main_problem.jobs.empty() ? 0 : main_problem.jobs[0].get_pe())
+		+ ", " + std::to_string(main_problem.jobs.size())
+		+ ", " + std::to_string(space.number_of_states())
+		+ ", " + std::to_string(space.get_cpu_time())
+		+ ", " + std::to_string(space.get_wall_time()) + "\n";
+	main_result.por_stats.merge(space.get_reduction_set_statistics());
+	main_result.exploration_stats.merge(space.get_exploration_statistics());
+
+	for (const auto &j: main_problem.jobs) {
+		Interval<Time> start = space.get_start_times(j);
+		Interval<Time> finish = space.get_finish_times(j);
+
+		// add the start and finish times to the main result
+		main_result.sta.emplace(j.get_id(), start);
+		main_result.rta.emplace(j.get_id(), finish);
+
+	}
+#ifdef CONFIG_COLLECT_SCHEDULE_GRAPH
+	if (want_dot_graph)
+	graph << space;
+#else
+	(void) graph;
+#endif
+}
+
+// checkpoint file of one partition of a model
+static std::string checkpoint_name(const std::string &fname, int pe) {
+	std::string name = fname;
+	auto p = name.find(".yaml");
+	if (p != std::string::npos)
+		name.erase(p);
+	return name + ".pe" + std::to_string(pe) + ".ckpt";
+}
+
+// the same model with another time type
+template<class To, class From>
+static Prepared_model<To> convert_model(const Prepared_model<From> &model) {
+	Prepared_model<To> converted;
+	converted.dag = NP::dag<To>(model.dag);
+	converted.time_base = (To) model.time_base;
+	converted.stream_chains = model.stream_chains;
+	return converted;
+}
+
+template<class Time, class Space>
+Analysis_result<Time> analyze(
+		Prepared_model<Time> &model, const std::string &fname) {
+
+	auto &dag = model.dag;
+	bool stream_chains = model.stream_chains;
+
+	// times are reported in input units, which may not fit into Time
+	typedef decltype(Time() * 1LL) Output_time;
+	Output_time time_base = model.time_base;
+	auto to_output_time = [time_base](Time t) -> Output_time {
+		if (t == Time_model::constants<Time>::infinity())
+			return Time_model::constants<Output_time>::infinity();
+		return t * time_base;
+	};
 
 	// generate a job set from dag
-	auto jobs = NP::generate_job_set<Time>(dag);
+	auto generated = [&dag] {
+		NP::Trace_span span("analysis", "job generation");
+		return NP::generate_job_set<Time>(dag);
+	}();
+	const auto &jobs = generated.jobs;
 
 
 
 	// now we have to run the main analysis
 	Analysis_result<Time> main_result;
 	auto graph = std::ostringstream();
-	// we have to separate the jobs for each processor
+	// the jobs are already separated for each processor
 	for (int i = 0; i < num_processors; ++i) {
-		typename NP::Job<Time>::Job_set par_jobs;
-		std::vector<std::size_t> indexes;
-		for (int j = 0; j < jobs.size(); ++j) {
-			if (jobs[j].get_pe() == i) {
-				par_jobs.push_back(jobs[j]);
-				indexes.push_back(j);
-			}
-		}
+		auto par_jobs = generated.workload_of_pe(i);
 		if (par_jobs.empty()) {
 			continue;
 		}
 
 
-		NP::Scheduling_problem<Time> main_problem{par_jobs,1};
+		NP::Scheduling_problem<Time> main_problem{std::move(par_jobs), 1};
 
 		// Set common analysis options
 		NP::Analysis_options opts;
 		opts.timeout = timeout;
+		opts.timeout_clock = timeout_clock;
+		opts.memory_limit = memory_limit;
+		opts.out_of_core = want_out_of_core;
+		opts.subsumption = want_subsumption;
+		opts.merge_tolerance = merge_tolerance / time_base;
+		opts.merge_cap = merge_cap;
+		if (want_checkpoints && fname != "-") {
+			opts.checkpoint_file = checkpoint_name(fname, i);
+			opts.checkpoint_interval = checkpoint_interval;
+		}
+		if (want_resume && fname != "-")
+			opts.resume_file = checkpoint_name(fname, i);
+		opts.progress_interval = progress_interval;
+		opts.progress_label = fname + " PE " + std::to_string(i);
 		opts.max_depth = max_depth;
 		opts.early_exit = !continue_after_dl_miss;
 		opts.num_buckets = main_problem.jobs.size();
 		opts.be_naive = want_naive;
 
-		// Actually call the analysis engine
-		auto space = Space::explore(main_problem, opts);
-
-		// Extract the analysis results
-		main_result.schedulable = main_result.schedulable && space.is_schedulable();
-		main_result.timeout = main_result.timeout || space.was_timed_out();
-		main_result.number_of_states += space.number_of_states();
-		main_result.number_of_edges += space.number_of_edges();
-		main_result.max_width = std::max(main_result.max_width,
-										 (unsigned long long) space.max_exploration_front_width());
-		main_result.number_of_jobs += par_jobs.size();
-		main_result.cpu_time += space.get_cpu_time();
-
-		for (int j = 0; j < par_jobs.size(); ++j) {
-			Interval<Time> start = space.get_start_times(main_problem.jobs[j]);
-			Interval<Time> finish = space.get_finish_times(main_problem.jobs[j]);
-
-			// add the start and finish times to the main result
-			main_result.sta.emplace(par_jobs[j].get_id(), start);
-			main_result.rta.emplace(par_jobs[j].get_id(), finish);
-
-		}
-#ifdef CONFIG_COLLECT_SCHEDULE_GRAPH
-		if (want_dot_graph)
-		graph << space;
-#endif
+		// Actually call the analysis engine; the input format has no abort
+		// actions, so abort handling is compiled out
+		explore_problem<Time, typename Space::Abort_free>(main_problem, opts, main_result, graph);
 	}
 
 	//
 	main_result.graph = graph.str();
+	main_result.max_widening *= time_base;
 
 	auto rta = std::ostringstream();
 
 	if (want_rta_file) {
+		NP::Trace_span span("analysis", "response times");
 		rta << "Task ID, Job ID, BCCT, WCCT, BCRT, WCRT" << std::endl;
 		for (const auto &j: jobs) {
 			Interval<Time> finish = main_result.rta.find(j.get_id())->second;
+			Output_time bcct = to_output_time(finish.from());
+			Output_time wcct = to_output_time(finish.until());
+			Output_time arrival = to_output_time(j.earliest_arrival());
 			rta << j.get_task_id() << ", "
 				<< j.get_job_id() << ", "
-				<< finish.from() << ", "
-				<< finish.until() << ", "
-				<< std::max<long long>(0,
-									   (finish.from() - j.earliest_arrival()))
+				<< bcct << ", "
+				<< wcct << ", "
+				<< std::max<long long>(0, (bcct - arrival))
 				<< ", "
-				<< (finish.until() - j.earliest_arrival())
+				<< (wcct - arrival)
 				<< std::endl;
 		}
 	}
 	main_result.response_times_csv = rta.str();
 	if (main_result.schedulable) {
+		NP::Trace_span span("analysis", "data-age analysis");
 		int index = 0;
 		csvfile csv_DA("results_DA.csv", true, ",");
 		// now we perform the latency analysis
-		for (const auto &tc: dag.get_task_chains()) {
+		auto analyze_chain = [&](const typename NP::dag<Time>::Task_chain &tc) {
 			// skip if the chain has only one task
 			if (tc.size() == 1) {
 				index++;
-				continue;
+				return;
 			}
+			NP::Trace_span chain_span("analysis", "chain " + std::to_string(index));
 			std::string chain_string;
 			for (int j = 0; j < tc.size(); ++j) {
 				if (j != 0) {
@@ -179,7 +366,6 @@ Analysis_result<Time> analyze(
 					chain_string.append(tc[j]->get_name());
 				}
 			}
-			Time HPchain = dag.get_chain_hyperperiod(index);
 			auto latency_analysis = NP::Data_age_analysis<Time>(jobs, main_result.sta, main_result.rta, tc);
 			auto data_age_bound = latency_analysis.get_data_age();
 
@@ -190,11 +376,21 @@ Analysis_result<Time> analyze(
 			auto label = fname;
 			label.append(" - ").append(std::to_string(index));
 			csv_DA << label;
-			csv_DA << (double) data_age_bound.from();
-			csv_DA << (double) data_age_bound.until();
+			csv_DA << (double) to_output_time(data_age_bound.from());
+			csv_DA << (double) to_output_time(data_age_bound.until());
 			csv_DA << "";
 			csv_DA << endrow;
 			index++;
+		};
+
+		if (stream_chains) {
+			NP::Chain_enumerator<Time> chains(dag, chain_opts);
+			typename NP::dag<Time>::Task_chain tc;
+			while (chains.next(tc))
+				analyze_chain(tc);
+		} else {
+			for (const auto &tc: dag.get_task_chains())
+				analyze_chain(tc);
 		}
 	}
 
@@ -202,81 +398,156 @@ Analysis_result<Time> analyze(
 }
 
 template<class Time>
-static Analysis_result<Time> process_stream(
-		std::istream &in, const std::string &fname) {
-	return analyze<Time,NP::Uniproc::Por_state_space<Time, NP::Uniproc::Null_IIP<Time>, NP::Uniproc::POR_release_order<Time>>>(in, fname);
-
+static Analysis_result<Time> process_model(
+		Prepared_model<Time> &model, const std::string &fname) {
+	using namespace NP::Uniproc;
+
+	if (por_mode == "off")
+		return analyze<Time, State_space<Time, Null_IIP<Time>>>(model, fname);
+	else if (por_mode == "priority")
+		return analyze<Time, Por_state_space<Time, Null_IIP<Time>, POR_priority_order<Time>>>(model, fname);
+	else if (por_mode == "adaptive")
+		return analyze<Time, Por_state_space<Time, Null_IIP<Time>, POR_adaptive<Time>>>(model, fname);
+	else
+		return analyze<Time, Por_state_space<Time, Null_IIP<Time>, POR_release_order<Time>>>(model, fname);
 }
 
-template<class Time>
-static void process_file(const std::string &fname) {
+// Discrete-time models whose time horizon (after normalisation) fits into
+// 32 bits are analysed with the compact time type, which yields identical
+// results with smaller states and jobs.
+static bool fits_compact_time(const Prepared_model<dtime_t> &model) {
+	if (!want_compact_time)
+		return false;
+	NP::Trace_span span("analysis", "time type selection");
 	try {
-		Analysis_result<Time> result;
-
-		auto empty_dag_stream = std::istringstream("\n");
-		auto empty_aborts_stream = std::istringstream("\n");
-		auto dag_stream = std::ifstream();
-		auto aborts_stream = std::ifstream();
+		return model.dag.get_time_horizon() <= Time_model::constants<dtime32_t>::safe_horizon();
+	} catch (NP::Hyperperiod_overflow &ex) {
+		return false;
+	}
+}
 
+static bool fits_compact_time(const Prepared_model<dense_t> &) {
+	return false;
+}
 
-		if (fname == "-")
-			result = process_stream<Time>(std::cin, "-");
-		else {
-			auto in = std::ifstream(fname, std::ios::in);
-			result = process_stream<Time>(in, fname);
+// write the result files of a model and its line of the result table
+template<class Time>
+static void report_result(const std::string &fname, Analysis_result<Time> result) {
+	if (fname != "-") {
 #ifdef CONFIG_COLLECT_SCHEDULE_GRAPH
-			if (want_dot_graph) {
-				std::string dot_name = fname;
-				auto p = dot_name.find(".yaml");
-				// add the main graph scope to the graph
-				result.graph.insert(0, "digraph G {\n");
-				result.graph.append("}");
-				if (p != std::string::npos) {
-					dot_name.replace(p, std::string::npos, ".dot");
-					auto out  = std::ofstream(dot_name,  std::ios::out);
-					out << result.graph;
-					out.close();
-				}
+		if (want_dot_graph) {
+			std::string dot_name = fname;
+			auto p = dot_name.find(".yaml");
+			// add the main graph scope to the graph
+			result.graph.insert(0, "digraph G {\n");
+			result.graph.append("}");
+			if (p != std::string::npos) {
+				dot_name.replace(p, std::string::npos, ".dot");
+				auto out  = std::ofstream(dot_name,  std::ios::out);
+				out << result.graph;
+				out.close();
 			}
+		}
 #endif
-			if (want_rta_file) {
-				std::string rta_name = fname;
-				auto p = rta_name.find(".yaml");
-				if (p != std::string::npos) {
-					rta_name.replace(p, std::string::npos, ".rta.csv");
-					auto out = std::ofstream(rta_name, std::ios::out);
-					out << result.response_times_csv;
-					out.close();
-				}
+		if (want_rta_file) {
+			std::string rta_name = fname;
+			auto p = rta_name.find(".yaml");
+			if (p != std::string::npos) {
+				rta_name.replace(p, std::string::npos, ".rta.csv");
+				auto out = std::ofstream(rta_name, std::ios::out);
+				out << result.response_times_csv;
+				out.close();
+			}
+		}
+		if (want_times_file) {
+			std::string times_name = fname;
+			auto p = times_name.find(".yaml");
+			if (p != std::string::npos) {
+				times_name.replace(p, std::string::npos, ".times.csv");
+				auto out = std::ofstream(times_name, std::ios::out);
+				out << "PE, #jobs, #states, CPU time, wall time" << std::endl
+					<< result.partition_times_csv
+					<< "total, " << result.number_of_jobs
+					<< ", " << result.number_of_states
+					<< ", " << std::to_string(result.cpu_time)
+					<< ", " << std::to_string(result.wall_time) << std::endl;
+				out.close();
+			}
+		}
+		if (want_por_stats_file) {
+			std::string stats_name = fname;
+			auto p = stats_name.find(".yaml");
+			if (p != std::string::npos) {
+				stats_name.replace(p, std::string::npos, ".por.json");
+				auto out = std::ofstream(stats_name, std::ios::out);
+				result.por_stats.write_json(out);
+				out.close();
 			}
 		}
+#ifdef CONFIG_COLLECT_STATISTICS
+		if (want_exploration_stats_file) {
+			std::string stats_name = fname;
+			auto p = stats_name.find(".yaml");
+			if (p != std::string::npos) {
+				stats_name.replace(p, std::string::npos, ".stats.json");
+				auto out = std::ofstream(stats_name, std::ios::out);
+				result.exploration_stats.write_json(out);
+				out.close();
+			}
+		}
+#endif
+	}
 
 #ifdef _WIN32 // rusage does not work under Windows
-		long mem_used = 0;
+	long mem_used = 0;
 #else
-		struct rusage u;
-		long mem_used = 0;
-		if (getrusage(RUSAGE_SELF, &u) == 0)
-			mem_used = u.ru_maxrss;
+	struct rusage u;
+	long mem_used = 0;
+	if (getrusage(RUSAGE_SELF, &u) == 0)
+		mem_used = u.ru_maxrss;
 #endif
 
-		std::cout << fname;
+	std::cout << fname;
+
+	if (max_depth && max_depth < result.number_of_jobs)
+		// mark result as invalid due to debug abort
+		std::cout << ",  X";
+	else
+		std::cout << ",  " << (int) result.schedulable;
+
+	std::cout << ",  " << result.number_of_jobs
+			  << ",  " << result.number_of_states
+			  << ",  " << result.number_of_edges
+			  << ",  " << result.max_width
+			  << ",  " << std::fixed << result.cpu_time
+			  << ",  " << ((double) mem_used) / (1024.0)
+			  // 1: timed out, 2: ran out of memory
+			  << ",  " << (result.memory_exhausted ? 2 : (int) result.timeout)
+			  << ",  " << num_processors
+			  << ",  " << result.wall_time
+			  << ",  " << result.number_of_subsumed_states
+			  << ",  " << result.number_of_approximate_merges
+			  << ",  " << result.max_widening
+			  << std::endl;
+}
 
-		if (max_depth && max_depth < result.number_of_jobs)
-			// mark result as invalid due to debug abort
-			std::cout << ",  X";
-		else
-			std::cout << ",  " << (int) result.schedulable;
-
-		std::cout << ",  " << result.number_of_jobs
-				  << ",  " << result.number_of_states
-				  << ",  " << result.number_of_edges
-				  << ",  " << result.max_width
-				  << ",  " << std::fixed << result.cpu_time
-				  << ",  " << ((double) mem_used) / (1024.0)
-				  << ",  " << (int) result.timeout
-				  << ",  " << num_processors
-				  << std::endl;
+// parse and analyse one model file ("-" for stdin)
+template<class Time>
+static void process_file(const std::string &fname) {
+	NP::Trace_span span("file", fname);
+	try {
+		auto model = [&fname] {
+			if (fname == "-")
+				return prepare_model<Time>(std::cin);
+			auto in = std::ifstream(fname, std::ios::in);
+			return prepare_model<Time>(in);
+		}();
+
+		if (fits_compact_time(model)) {
+			auto compact = convert_model<dtime32_t>(model);
+			report_result(fname, process_model(compact, fname));
+		} else
+			report_result(fname, process_model(model, fname));
 	} catch (std::ios_base::failure &ex) {
 		std::cerr << fname;
 		if (want_precedence)
@@ -296,6 +567,42 @@ static void process_file(const std::string &fname) {
 	}
 }
 
+// signal handler: SIGTERM checkpoints and stops, other signals only checkpoint;
+// outside an exploration there is nothing to checkpoint, so SIGTERM
+// terminates right away and other signals are ignored
+static void request_checkpoint(int sig) {
+	if (!exploring) {
+		if (sig == SIGTERM) {
+			std::signal(SIGTERM, SIG_DFL);
+			std::raise(SIGTERM);
+		}
+		return;
+	}
+	NP::pending_checkpoint_request() = sig == SIGTERM
+									   ? NP::checkpoint_and_stop
+									   : NP::checkpoint_and_continue;
+}
+
+// parse a comma-separated list of task IDs given with the named option;
+// throws std::invalid_argument
+static std::vector<unsigned long> parse_task_ids(const std::string &list, const std::string &option) {
+	std::vector<unsigned long> ids;
+	std::istringstream in(list);
+	std::string id;
+	while (std::getline(in, id, ',')) {
+		if (id.empty())
+			continue;
+		if (id.find_first_not_of("0123456789") != std::string::npos)
+			throw std::invalid_argument(option + ": invalid task ID '" + id + "'");
+		try {
+			ids.push_back(std::stoul(id));
+		} catch (std::out_of_range &ex) {
+			throw std::invalid_argument(option + ": invalid task ID '" + id + "'");
+		}
+	}
+	return ids;
+}
+
 static void print_header() {
 	std::cout << "# file name"
 			  << ", schedulable?"
@@ -307,6 +614,10 @@ static void print_header() {
 			  << ", memory"
 			  << ", timeout"
 			  << ", #CPUs"
+			  << ", wall time"
+			  << ", #subsumed"
+			  << ", #approximate merges"
+			  << ", max widening"
 			  << std::endl;
 }
 
@@ -326,7 +637,49 @@ int main(int argc, char **argv) {
 			.help("choose 'discrete' or 'dense' time (default: discrete)");
 
 	parser.add_option("-l", "--time-limit").dest("timeout")
-			.help("maximum CPU time allowed (in seconds, zero means no limit)")
+			.help("time allowed, as measured by --time-limit-clock (in seconds, "
+				  "zero means no limit)")
+			.set_default("0");
+
+	parser.add_option("--time-limit-clock").dest("timeout_clock")
+			.metavar("CLOCK")
+			.choices({"thread", "process", "wall"}).set_default("thread")
+			.help("measure the time limit as CPU time of the analysis thread ('thread'), "
+				  "CPU time of the whole process ('process') or wall-clock time ('wall') "
+				  "(default: thread)");
+
+	parser.add_option("--memory-limit").dest("memory_limit")
+			.metavar("MIB")
+			.help("memory the states of one partition may occupy (in MiB, zero means no limit); "
+				  "close to the limit the analysis merges states less accurately, and at the "
+				  "limit it gives up and reports 2 in the timeout column")
+			.set_default("0");
+
+	parser.add_option("--out-of-core").dest("out_of_core").set_default("0")
+			.action("store_const").set_const("1")
+			.help("keep unexplored states in temporary files and merge them on disk, "
+				  "one depth at a time, so that memory use does not grow with the width "
+				  "of the exploration front (default: off)");
+
+	parser.add_option("--subsume").dest("subsume").set_default("0")
+			.action("store_const").set_const("1")
+			.help("also merge states with the same scheduled jobs whose finish ranges "
+				  "are adjacent, and drop states that a merge has made redundant; the "
+				  "number of such states is reported in the #subsumed column (default: off)");
+
+	parser.add_option("--merge-tolerance").dest("merge_tolerance")
+			.metavar("TIME")
+			.help("also merge states with the same scheduled jobs whose finish ranges "
+				  "are at most TIME apart; the bounds become more pessimistic, the number "
+				  "of such merges and the largest gap are reported in the "
+				  "#approximate merges and max widening columns (default: 0)")
+			.set_default("0");
+
+	parser.add_option("--merge-cap").dest("merge_cap")
+			.metavar("NUM")
+			.help("merge a new state into the closest state with the same scheduled "
+				  "jobs if there are NUM such states already, even if their finish "
+				  "ranges are apart (zero means no cap) (default: 0)")
 			.set_default("0");
 
 	parser.add_option("-d", "--depth-limit").dest("depth")
@@ -337,6 +690,67 @@ int main(int argc, char **argv) {
 			.action("store_const").set_const("1")
 			.help("use the naive exploration method (default: merging)");
 
+	parser.add_option("--por").dest("por")
+			.metavar("CRITERION")
+			.choices({"release", "priority", "adaptive", "off"}).set_default("release")
+			.help("choose the partial-order reduction criterion: 'release', 'priority', "
+				  "'adaptive' or 'off' (default: release)");
+
+	parser.add_option("--chain-objective").dest("chain_objective")
+			.metavar("OBJECTIVE")
+			.choices({"hops", "periods", "wcets"}).set_default("hops")
+			.help("choose how the default task chain is selected if the input has none: "
+				  "most tasks ('hops'), largest sum of periods ('periods') or of WCETs ('wcets') "
+				  "(default: hops)");
+
+	parser.add_option("--wide-time").dest("wide_time").set_default("0")
+			.action("store_const").set_const("1")
+			.help("always use 64-bit discrete time, even if the time horizon of a "
+				  "model fits into 32 bits (default: off)");
+
+	parser.add_option("--normalize-time").dest("normalize_time").set_default("0")
+			.action("store_const").set_const("1")
+			.help("divide all timing parameters by their greatest common divisor "
+				  "before the analysis (default: off)");
+
+	parser.add_option("--time-quantum").dest("time_quantum")
+			.help("round all timing parameters conservatively to multiples of this "
+				  "quantum before the analysis; periods must be multiples of it, and it "
+				  "must be a whole number with discrete time (zero means no rounding)")
+			.set_default("0");
+
+	parser.add_option("--chain-window").dest("chain_window").set_default("0")
+			.action("store_const").set_const("1")
+			.help("size the observation window by the hyperperiod of the tasks that can "
+				  "affect the analysed chains (all tasks on their PEs and the predecessors "
+				  "of these, transitively) instead of the hyperperiod of all tasks "
+				  "(default: off)");
+
+	parser.add_option("--all-chains").dest("all_chains").set_default("0")
+			.action("store_const").set_const("1")
+			.help("if the input has no task chains, analyse every source-to-sink chain "
+				  "(enumerated lazily) instead of only the longest one (default: off)");
+
+	parser.add_option("--max-chains").dest("max_chains")
+			.help("analyse at most this many chains with --all-chains (zero means no limit)")
+			.set_default("0");
+
+	parser.add_option("--max-chain-length").dest("max_chain_length")
+			.help("skip chains with more tasks than this with --all-chains (zero means no limit)")
+			.set_default("0");
+
+	parser.add_option("--chain-sources").dest("chain_sources")
+			.metavar("TASK-IDS")
+			.help("comma-separated task IDs at which chains may start with --all-chains "
+				  "(default: all source tasks)")
+			.set_default("");
+
+	parser.add_option("--chain-sinks").dest("chain_sinks")
+			.metavar("TASK-IDS")
+			.help("comma-separated task IDs at which chains may end with --all-chains "
+				  "(default: all sink tasks)")
+			.set_default("");
+
 	parser.add_option("-w", "--wcet").dest("worse_case").set_default("0")
 			.action("store_const").set_const("1")
 			.help("use WCET as actual execution time and zero jitter for every job (default: off)");
@@ -354,6 +768,49 @@ int main(int argc, char **argv) {
 			.action("store_const").set_const("1")
 			.help("store the best- and worst-case response times (default: off)");
 
+	parser.add_option("--save-por-stats").dest("por_stats").set_default("0")
+			.action("store_const").set_const("1")
+			.help("store partial-order reduction statistics in JSON format (default: off)");
+
+	parser.add_option("--save-stats").dest("exploration_stats").set_default("0")
+			.action("store_const").set_const("1")
+			.help("store the exploration counters and per-phase timers in JSON format "
+				  "(requires a build with COLLECT_STATISTICS) (default: off)");
+
+	parser.add_option("--save-times").dest("times").set_default("0")
+			.action("store_const").set_const("1")
+			.help("store the CPU and wall-clock time of each partition (default: off)");
+
+	parser.add_option("--trace").dest("trace").metavar("FILE")
+			.help("record a timeline of the analysis phases in Chrome trace-event "
+				  "format, e.g., for chrome://tracing or Perfetto (default: off)")
+			.set_default("");
+
+	parser.add_option("--progress").dest("progress").metavar("SECONDS")
+			.help("report the progress of each partition as one JSON line every "
+				  "SECONDS of wall-clock time (default: off)")
+			.set_default("0");
+
+	parser.add_option("--progress-file").dest("progress_file").metavar("FILE")
+			.help("append the progress reports to FILE (default: stderr)")
+			.set_default("");
+
+	parser.add_option("--checkpoint").dest("checkpoint").set_default("0")
+			.action("store_const").set_const("1")
+			.help("write a checkpoint of each partition to <model>.pe<N>.ckpt "
+				  "periodically, on SIGUSR1, and on SIGTERM (then exit) (default: off)");
+
+	parser.add_option("--checkpoint-interval").dest("checkpoint_interval")
+			.metavar("SECONDS")
+			.help("wall-clock time between two periodic checkpoints (zero means "
+				  "only on signals) (default: 600)")
+			.set_default("600");
+
+	parser.add_option("--resume").dest("resume").set_default("0")
+			.action("store_const").set_const("1")
+			.help("continue from the checkpoints written with --checkpoint by an "
+				  "earlier run with the same options (default: off)");
+
 	parser.add_option("-c", "--continue-after-deadline-miss")
 			.dest("go_on_after_dl").set_default("0")
 			.action("store_const").set_const("1")
@@ -363,13 +820,62 @@ int main(int argc, char **argv) {
 
 	auto options = parser.parse_args(argc, argv);
 
-	const std::string &time_model = options.get("time_model");
+	std::string time_model = options.get("time_model");
 	want_dense = time_model == "dense";
 
 	want_naive = options.get("naive");
 
+	por_mode = (std::string) options.get("por");
+
+	want_compact_time = !options.get("wide_time");
+	want_time_normalization = options.get("normalize_time");
+	time_quantum = options.get("time_quantum");
+	if (time_quantum < 0) {
+		std::cerr << "Error: the time quantum must not be negative" << std::endl;
+		return 1;
+	}
+	// would be truncated to a different quantum (or to none at all)
+	if (!want_dense && time_quantum != std::floor(time_quantum)) {
+		std::cerr << "Error: the time quantum must be a whole number with discrete time" << std::endl;
+		return 1;
+	}
+	want_all_chains = options.get("all_chains");
+	want_chain_window = options.get("chain_window");
+	chain_opts.max_chains = (unsigned long) options.get("max_chains");
+	chain_opts.max_length = (unsigned long) options.get("max_chain_length");
+	try {
+		chain_opts.sources = parse_task_ids(options.get("chain_sources"), "--chain-sources");
+		chain_opts.sinks = parse_task_ids(options.get("chain_sinks"), "--chain-sinks");
+	} catch (std::invalid_argument &ex) {
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	std::string objective = options.get("chain_objective");
+	if (objective == "periods")
+		chain_objective = NP::Chain_objective::period_sum;
+	else if (objective == "wcets")
+		chain_objective = NP::Chain_objective::wcet_sum;
+
 	timeout = options.get("timeout");
 
+	memory_limit = (std::size_t) ((double) options.get("memory_limit") * 1024 * 1024);
+
+	want_out_of_core = options.get("out_of_core");
+
+	want_subsumption = options.get("subsume");
+
+	merge_tolerance = options.get("merge_tolerance");
+	merge_cap = (unsigned long) options.get("merge_cap");
+
+	std::string clock_name = options.get("timeout_clock");
+	if (clock_name == "process")
+		timeout_clock = Clock_source::process_cpu;
+	else if (clock_name == "wall")
+		timeout_clock = Clock_source::wall;
+	else
+		timeout_clock = Clock_source::thread_cpu;
+
 	max_depth = options.get("depth");
 	if (options.is_set_by_user("depth")) {
 		if (max_depth <= 1) {
@@ -390,6 +896,20 @@ int main(int argc, char **argv) {
 
 	want_rta_file = options.get("rta");
 
+	want_por_stats_file = options.get("por_stats");
+
+	want_times_file = options.get("times");
+
+	want_checkpoints = options.get("checkpoint");
+	checkpoint_interval = options.get("checkpoint_interval");
+	want_resume = options.get("resume");
+	if (want_checkpoints) {
+		std::signal(SIGTERM, request_checkpoint);
+#ifndef _WIN32
+		std::signal(SIGUSR1, request_checkpoint);
+#endif
+	}
+
 	want_worst_case = options.get("worse_case");
 
 	continue_after_dl_miss = options.get("go_on_after_dl");
@@ -405,14 +925,46 @@ int main(int argc, char **argv) {
 	}
 #endif
 
+#ifdef CONFIG_COLLECT_STATISTICS
+	want_exploration_stats_file = options.get("exploration_stats");
+#else
+	if (options.is_set_by_user("exploration_stats")) {
+		std::cerr << "Error: statistics support must be enabled "
+				  << "during compilation (CONFIG_COLLECT_STATISTICS "
+				  << "is not set)." << std::endl;
+		return 2;
+	}
+#endif
+
+
+	progress_interval = options.get("progress");
+	std::string progress_file = options.get("progress_file");
+	if (progress_interval < 0) {
+		std::cerr << "Error: the progress interval must not be negative" << std::endl;
+		return 1;
+	}
+	if (progress_interval > 0 && !progress_file.empty()) {
+		try {
+			NP::progress().open(progress_file);
+		} catch (std::exception &ex) {
+			std::cerr << "Error: " << ex.what() << std::endl;
+			return 1;
+		}
+	}
+
+	std::string trace_file = options.get("trace");
+	if (!trace_file.empty())
+		NP::trace().open(trace_file);
 
 	if (options.get("print_header"))
 		print_header();
 
+	// discrete-time models are prepared with 64-bit time and analysed with
+	// the compact time type if they fit into it
 	for (auto f: parser.args())
 		if (want_dense)
 			process_file<dense_t>(f);
-		else if (!want_dense)
+		else
 			process_file<dtime_t>(f);
 
 	if (parser.args().empty())
@@ -421,5 +973,10 @@ int main(int argc, char **argv) {
 		else if (!want_dense)
 			process_file<dtime_t>("-");
 
+	if (NP::trace().enabled() && !NP::trace().write()) {
+		std::cerr << "Error: cannot write the trace to " << trace_file << std::endl;
+		return 1;
+	}
+
 	return 0;
 }